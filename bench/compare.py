@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Compare two vdm-bench JSON result files.
+
+Usage: compare.py BASELINE.json CURRENT.json [--threshold PCT]
+
+Prints per-benchmark deltas for ns/op, allocs/op and bytes/op and exits
+non-zero when any benchmark got slower than the threshold (default 10%).
+"""
+
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return {(b["name"], b["workspaces"], b["monitors"]): b for b in data["benchmarks"]}
+
+
+def delta(old, new):
+    if old == 0:
+        return 0.0 if new == 0 else float("inf")
+    return (new - old) / old * 100.0
+
+
+def main(argv):
+    args = [a for a in argv[1:] if not a.startswith("--")]
+    threshold = 10.0
+    if "--threshold" in argv:
+        threshold = float(argv[argv.index("--threshold") + 1])
+        args.remove(argv[argv.index("--threshold") + 1])
+    if len(args) != 2:
+        print(__doc__, file=sys.stderr)
+        return 2
+
+    baseline, current = load(args[0]), load(args[1])
+    regressions = 0
+
+    print(f"{'benchmark':48} {'ws':>6} {'mon':>4} {'ns/op':>18} {'allocs/op':>16} {'bytes/op':>18}")
+    for key in sorted(current):
+        new = current[key]
+        old = baseline.get(key)
+        name, ws, mon = key
+        if old is None:
+            print(f"{name:48} {ws:>6} {mon:>4} {new['ns_per_op']:>10.1f} (new)")
+            continue
+
+        ns = delta(old["ns_per_op"], new["ns_per_op"])
+        if ns > threshold:
+            regressions += 1
+        print(f"{name:48} {ws:>6} {mon:>4} "
+              f"{new['ns_per_op']:>10.1f} {ns:>+6.1f}% "
+              f"{new['allocs_per_op']:>8.2f} {delta(old['allocs_per_op'], new['allocs_per_op']):>+6.1f}% "
+              f"{new['bytes_per_op']:>10.1f} {delta(old['bytes_per_op'], new['bytes_per_op']):>+6.1f}%")
+
+    if regressions:
+        print(f"\n{regressions} benchmark(s) slower than {threshold:.0f}%")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,846 @@
+// vdm-bench: microbenchmarks for the VDM hot paths, run against CMockBackend
+//
+// Usage: vdm-bench [--filter SUBSTR] [--min-time-ms N] [--json PATH] [--check]
+//                  [--check-log PATH]
+//
+// Every benchmark reports ns/op, allocations/op and bytes/op. Allocations are
+// counted by replacing the global operator new in this executable only.
+// Results can be written as JSON and compared with bench/compare.py.
+// Benchmarks that need a working setup check it first; a failed check is
+// printed and makes the run exit with status 1. --check runs the checks
+// alone, without timing anything; --check-log also writes a binary log of
+// known records for vdm-logdecode to render back (see CMakeLists.txt).
+
+#include "DesktopBitset.hpp"
+#include "MockBackend.hpp"
+#include "PerfectHash.hpp"
+#include "WorkspaceIDAllocator.hpp"
+#include "workspace_manager.hpp"
+#include "command_handlers.hpp"
+#include "VirtualDesktop.hpp"
+#include "VirtualDesktopManager.hpp"
+#include "EventServer.hpp"
+#include "LoggerFacade.hpp"
+#include "NotificationScheduler.hpp"
+#include "Serializer.hpp"
+#include "Stats.hpp"
+#include "Trace.hpp"
+#include "globals.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// ---- Allocation accounting ----
+
+namespace {
+    std::atomic<uint64_t> gAllocCount{0};
+    std::atomic<uint64_t> gAllocBytes{0};
+
+    void* countedAlloc(std::size_t size) {
+        gAllocCount.fetch_add(1, std::memory_order_relaxed);
+        gAllocBytes.fetch_add(size, std::memory_order_relaxed);
+        if (void* p = std::malloc(size ? size : 1))
+            return p;
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+    using namespace VDM;
+
+    // Keep the optimizer from discarding benchmark results
+    template <typename T>
+    inline void doNotOptimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    struct SBenchConfig {
+        std::string filter;
+        int minTimeMs = 100;
+        std::string jsonPath;
+        bool checkOnly = false;
+        std::string checkLogPath;
+    };
+
+    struct SBenchResult {
+        std::string name;
+        int workspaces = 0;
+        int monitors = 0;
+        uint64_t iterations = 0;
+        double nsPerOp = 0;
+        double allocsPerOp = 0;
+        double bytesPerOp = 0;
+    };
+
+    SBenchConfig gConfig;
+    std::vector<SBenchResult> gResults;
+    bool gCheckFailed = false;
+
+    bool isSelected(std::string_view name) {
+        return gConfig.filter.empty() || name.find(gConfig.filter) != std::string_view::npos;
+    }
+
+    bool check(bool ok, const char* what) {
+        if (!ok) {
+            std::fprintf(stderr, "check failed: %s\n", what);
+            gCheckFailed = true;
+        }
+        return ok;
+    }
+
+    /**
+     * Run fn repeatedly for at least the configured minimum time, doubling
+     * the batch size until a batch is long enough to time reliably
+     */
+    void runBenchmark(const std::string& name, int workspaces, int monitors, const std::function<void()>& fn) {
+        if (gConfig.checkOnly || !isSelected(name))
+            return;
+
+        using clock = std::chrono::steady_clock;
+        const auto minTime = std::chrono::milliseconds(gConfig.minTimeMs);
+
+        // Warm up caches and lazily allocated state
+        for (int i = 0; i < 16; ++i)
+            fn();
+
+        uint64_t batch = 1;
+        for (;;) {
+            const uint64_t allocsBefore = gAllocCount.load(std::memory_order_relaxed);
+            const uint64_t bytesBefore = gAllocBytes.load(std::memory_order_relaxed);
+            const auto start = clock::now();
+
+            for (uint64_t i = 0; i < batch; ++i)
+                fn();
+
+            const auto elapsed = clock::now() - start;
+            if (elapsed < minTime && batch < (1ull << 40)) {
+                batch *= 2;
+                continue;
+            }
+
+            SBenchResult result;
+            result.name = name;
+            result.workspaces = workspaces;
+            result.monitors = monitors;
+            result.iterations = batch;
+            result.nsPerOp = std::chrono::duration<double, std::nano>(elapsed).count() / batch;
+            result.allocsPerOp = double(gAllocCount.load(std::memory_order_relaxed) - allocsBefore) / batch;
+            result.bytesPerOp = double(gAllocBytes.load(std::memory_order_relaxed) - bytesBefore) / batch;
+
+            std::printf("%-48s %6d %4d %12.1f %10.2f %12.1f\n", name.c_str(), workspaces, monitors,
+                        result.nsPerOp, result.allocsPerOp, result.bytesPerOp);
+            gResults.push_back(std::move(result));
+            return;
+        }
+    }
+
+    /**
+     * Populate a mock compositor with the given number of monitors and
+     * workspaces, spreading workspaces round-robin across monitors
+     */
+    void populate(CMockBackend& backend, int workspaces, int monitors) {
+        std::vector<MONITORID> monitorIDs;
+        for (int i = 0; i < monitors; ++i)
+            monitorIDs.push_back(backend.addMonitor(std::format("DP-{}", i + 1)));
+
+        // Every monitor already got a workspace when it was plugged in
+        for (int i = monitors; i < workspaces; ++i) {
+            const WORKSPACEID id = i + 1;
+            backend.createWorkspace(id, monitorIDs[i % monitors], std::to_string(id));
+            // A few windows so window counts are not trivially zero
+            if (i % 3 == 0)
+                backend.openWindow(id);
+        }
+    }
+
+    void benchWorkspaceManager(int workspaces, int monitors) {
+        CMockBackend backend;
+        populate(backend, workspaces, monitors);
+
+        auto* manager = CWorkspaceManager::getInstance();
+        manager->initialize(&backend);
+
+        runBenchmark("CWorkspaceManager::getAllWorkspaces", workspaces, monitors, [&] {
+            auto result = manager->getAllWorkspaces();
+            doNotOptimize(result);
+        });
+
+        runBenchmark("CWorkspaceManager::getAllMonitors", workspaces, monitors, [&] {
+            auto result = manager->getAllMonitors();
+            doNotOptimize(result);
+        });
+
+        runBenchmark("CWorkspaceManager::forEachWorkspace", workspaces, monitors, [&] {
+            size_t windows = 0;
+            manager->forEachWorkspace([&](const SWorkspaceInfoView& view) { windows += view.windows.windows + view.name.size(); });
+            doNotOptimize(windows);
+        });
+
+        runBenchmark("CWorkspaceManager::forEachMonitor", workspaces, monitors, [&] {
+            size_t total = 0;
+            manager->forEachMonitor([&](const SMonitorInfoView& view) { total += view.workspaces.size() + view.name.size(); });
+            doNotOptimize(total);
+        });
+
+        runBenchmark("CWorkspaceManager::getNextAvailableWorkspaceID", workspaces, monitors, [&] {
+            auto result = manager->getNextAvailableWorkspaceID();
+            doNotOptimize(result);
+        });
+
+        runBenchmark("Commands::handleVirtualDesktopList/json", workspaces, monitors, [&] {
+            auto result = Commands::handleVirtualDesktopList(FORMAT_JSON, "");
+            doNotOptimize(result);
+        });
+
+        runBenchmark("Commands::handleVirtualDesktopList/plain", workspaces, monitors, [&] {
+            auto result = Commands::handleVirtualDesktopList(FORMAT_NORMAL, "");
+            doNotOptimize(result);
+        });
+
+        // Typical bar query: occupied desktop IDs on one monitor, never cached
+        runBenchmark("Commands::handleVirtualDesktopList/bar", workspaces, monitors, [&] {
+            auto result = Commands::handleCommand(FORMAT_JSON, "vdm list fields=id occupied=1 monitor=DP-1");
+            doNotOptimize(result);
+        });
+
+        const std::string since = std::format("since={}", CVirtualDesktopManager::getInstance().getGeneration());
+        runBenchmark("Commands::handleVirtualDesktopList/since", workspaces, monitors, [&] {
+            auto result = Commands::handleVirtualDesktopList(FORMAT_JSON, since);
+            doNotOptimize(result);
+        });
+
+        CWorkspaceManager::destroy();
+    }
+
+    // Previous serializers, kept as baselines for CSerializer
+
+    std::string toStringDetailedStream(const CVirtualDesktop& desktop) {
+        std::ostringstream ss;
+        ss << "VirtualDesktop{id=" << desktop.getID() << ", name='" << desktop.getName() << "', active=" << std::boolalpha
+           << desktop.isActive() << ", workspaces=[";
+        const auto& ids = desktop.getWorkspaceIDs();
+        for (size_t i = 0; i < ids.size(); ++i)
+            ss << ids[i] << (i + 1 < ids.size() ? ", " : "");
+        ss << "]}";
+        return ss.str();
+    }
+
+    std::string desktopJsonFormat(const CVirtualDesktop& desktop, const SWindowCounters& counters) {
+        std::string out;
+        std::format_to(std::back_inserter(out), R"({{"id": {}, "name": "{}", "active": {}, "workspaces": [)",
+                       desktop.getID(), desktop.getName(), desktop.isActive());
+        const auto& ids = desktop.getWorkspaceIDs();
+        for (size_t i = 0; i < ids.size(); ++i)
+            std::format_to(std::back_inserter(out), "{}{}", i ? ", " : "", ids[i]);
+        std::format_to(std::back_inserter(out), R"(], "windows": {}, "fullscreen": {}, "urgent": {}}})",
+                       counters.windows, counters.fullscreen, counters.urgent);
+        return out;
+    }
+
+    void benchVirtualDesktop(int monitors) {
+        static const std::string NAME = "Benchmark desktop";
+
+        CLayout layout;
+        for (int i = 0; i < monitors; ++i)
+            layout.attachMonitor(i + 1, std::format("DP-{}", i + 1));
+
+        const auto& desktop = layout.createDesktop(NAME);
+        for (int i = 0; i < monitors; ++i)
+            layout.setWorkspaceID(desktop.getID(), i, i + 1);
+
+        runBenchmark("CVirtualDesktop::toStringDetailed", 0, monitors, [&] {
+            auto result = desktop.toStringDetailed();
+            doNotOptimize(result);
+        });
+
+        runBenchmark("CVirtualDesktop::toStringDetailed/ostringstream", 0, monitors, [&] {
+            auto result = toStringDetailedStream(desktop);
+            doNotOptimize(result);
+        });
+
+        const SWindowCounters counters{.windows = 5, .fullscreen = 1, .urgent = 0};
+
+        runBenchmark("desktop/json/std::format", 0, monitors, [&] {
+            auto result = desktopJsonFormat(desktop, counters);
+            doNotOptimize(result);
+        });
+
+        // Same buffer every time, as the listing cache does
+        std::string buffer;
+        runBenchmark("desktop/json/CSerializer", 0, monitors, [&] {
+            buffer.clear();
+            CSerializer out(buffer, FORMAT_JSON);
+            serialize(out, desktop, counters);
+            doNotOptimize(buffer);
+        });
+
+        runBenchmark("desktop/plain/CSerializer", 0, monitors, [&] {
+            buffer.clear();
+            CSerializer out(buffer, FORMAT_NORMAL);
+            serialize(out, desktop, counters);
+            doNotOptimize(buffer);
+        });
+    }
+
+    void benchLayout(int monitors) {
+        constexpr int DESKTOPS = 100;
+
+        CLayout layout;
+        for (int i = 0; i < monitors; ++i)
+            layout.attachMonitor(i + 1, std::format("DP-{}", i + 1));
+        for (int d = 1; d <= DESKTOPS; ++d) {
+            layout.createDesktop();
+            for (int i = 0; i < monitors; ++i)
+                layout.setWorkspaceID(d, i, (d - 1) * CVirtualDesktopManager::WORKSPACES_PER_DESKTOP + i + 1);
+        }
+
+        // Looked up on every window event; the last desktop is the worst case for a scan
+        const WORKSPACEID last = (DESKTOPS - 1) * CVirtualDesktopManager::WORKSPACES_PER_DESKTOP + monitors;
+        runBenchmark("CLayout::findDesktopByWorkspace", DESKTOPS * monitors, monitors, [&] {
+            auto* desktop = layout.findDesktopByWorkspace(last);
+            doNotOptimize(desktop);
+        });
+    }
+
+    void benchDesktopSwitch(int monitors) {
+        CMockBackend backend;
+        populate(backend, monitors, monitors);
+
+        auto* manager = CWorkspaceManager::getInstance();
+        manager->initialize(&backend);
+        auto& desktops = CVirtualDesktopManager::getInstance();
+        desktops.initialize(&backend);
+
+        // Create desktop 2 first, then measure flipping between the two. The
+        // desktop left behind only goes to the reclaimer, whose timer never
+        // fires here, so its workspaces stay live
+        desktops.switchToDesktop(2);
+        int target = 1;
+        runBenchmark("CVirtualDesktopManager::switchToDesktop", monitors * 2, monitors, [&] {
+            auto result = desktops.switchToDesktop(target);
+            doNotOptimize(result);
+            target = 3 - target;
+        });
+
+        // Key repeat: with a switch pending, every further request only
+        // replaces its target. The timer never fires, so it stays pending
+        desktops.setSwitchTimerCallback([](int) {});
+        desktops.switchToDesktop(1);
+        desktops.requestSwitch(2);
+        runBenchmark("CVirtualDesktopManager::requestSwitch/coalesced", monitors * 2, monitors, [&] {
+            auto success = desktops.requestSwitch(target);
+            doNotOptimize(success);
+            target = 3 - target;
+        });
+        desktops.setSwitchTimerCallback(nullptr);
+
+        // next-occupied reads the occupancy bitset, whatever the window count
+        backend.openWindow(desktops.getLayout().getWorkspaceID(2, 0));
+        runBenchmark("CVirtualDesktopManager::findOccupiedDesktop", monitors * 2, monitors, [&] {
+            auto found = desktops.findOccupiedDesktop(1, true);
+            doNotOptimize(found);
+        });
+
+        desktops.shutdown();
+        CWorkspaceManager::destroy();
+    }
+
+    void benchNotifications() {
+        CMockBackend backend;
+        CNotificationScheduler notifications(&backend);
+
+        // Bulk operation: everything after the first post lands in the burst
+        runBenchmark("CNotificationScheduler::post/merged", 0, 0, [&] {
+            notifications.post(NotifyTopics::WORKSPACE_CREATED, NOTIFY_OK, "[VDM] Created workspace {} ({})", 42,
+                               "bench");
+        });
+
+        notifications.setVerbosity(NOTIFY_VERBOSITY_OFF);
+        runBenchmark("CNotificationScheduler::post/off", 0, 0, [&] {
+            notifications.post(NotifyTopics::WORKSPACE_CREATED, NOTIFY_OK, "[VDM] Created workspace {} ({})", 42,
+                               "bench");
+        });
+    }
+
+    void benchCommands() {
+        runBenchmark("Commands::handleDbgPluginInfo/json", 0, 0, [] {
+            auto result = Commands::handleDbgPluginInfo(FORMAT_JSON, "");
+            doNotOptimize(result);
+        });
+
+        runBenchmark("Commands::handleDbgPluginInfo/plain", 0, 0, [] {
+            auto result = Commands::handleDbgPluginInfo(FORMAT_NORMAL, "");
+            doNotOptimize(result);
+        });
+
+        // Same handler through the subcommand table, arena and stats
+        runBenchmark("Commands::handleCommand/info", 0, 0, [] {
+            auto result = Commands::handleCommand(FORMAT_JSON, "vdm info");
+            doNotOptimize(result);
+        });
+    }
+
+    void benchStats() {
+        // Cost added to every instrumented entry point
+        runBenchmark("CStatScope", 0, 0, [] { VDM_STAT_SCOPE(STAT_DISPATCH_VDESK); });
+
+        runBenchmark("Stats::getSummary", 0, 0, [] {
+            auto summary = Stats::getSummary(STAT_DISPATCH_VDESK);
+            doNotOptimize(summary);
+        });
+
+        runBenchmark("Commands::handleStats/json", 0, 0, [] {
+            auto result = Commands::handleStats(FORMAT_JSON, "");
+            doNotOptimize(result);
+        });
+
+        Stats::reset();
+    }
+
+    void benchTrace() {
+        runBenchmark("CTraceScope/off", 0, 0, [] { VDM_TRACE_SCOPE("bench"); });
+
+        Trace::start();
+        runBenchmark("CTraceScope/on", 0, 0, [] { VDM_TRACE_SCOPE("bench"); });
+        runBenchmark("CStatScope/traced", 0, 0, [] { VDM_STAT_SCOPE(STAT_DISPATCH_VDESK); });
+        Trace::stop();
+
+        Stats::reset();
+    }
+
+    /**
+     * Connect a local client to an event server socket
+     * @return Non-blocking client FD, -1 on failure
+     */
+    int connectClient(const std::string& path) {
+        const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        if (fd == -1 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1) {
+            if (fd != -1)
+                close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    /**
+     * Read whatever a client has been sent so far
+     * @return false once the server has closed the connection
+     */
+    bool readClient(int fd, std::string& out) {
+        char buf[4096];
+        ssize_t n;
+        while ((n = recv(fd, buf, sizeof(buf), 0)) > 0)
+            out.append(buf, static_cast<size_t>(n));
+        return n != 0;
+    }
+
+    void benchEventServer() {
+        if (!isSelected("CEventServer::publish"))
+            return;
+
+        const std::string path = "/tmp/vdm-bench-" + std::to_string(getpid()) + ".sock";
+        CEventServer server;
+        if (!check(server.start(path), "event server listens"))
+            return;
+
+        const int reader = connectClient(path);
+        server.dispatch();
+        check(reader != -1 && server.getClientCount() == 1, "event client connects");
+
+        // Framing and sequence numbers, as a bar would parse them
+        std::string received;
+        server.publish("vdesk", "2");
+        server.publish("vdeskwindows", "2,5,1,0");
+        readClient(reader, received);
+        check(received == "vdesk>>1,2\nvdeskwindows>>2,2,5,1,0\n", "events are framed as EVENT>>SEQ,DATA");
+
+        // One event to a client that keeps up
+        runBenchmark("CEventServer::publish", 0, 0, [&] {
+            server.publish("vdeskwindows", "2,5,1,0");
+            received.clear();
+            readClient(reader, received);
+        });
+
+        // A client that never reads fills the socket buffer, then its 64 KiB
+        // queue, and is dropped; the reader is unaffected
+        const int stalled = connectClient(path);
+        server.dispatch();
+        const uint64_t droppedBefore = server.getDroppedClientCount();
+        for (int i = 0; i < 1'000'000 && server.getClientCount() == 2; ++i) {
+            server.publish("vdeskwindows", "2,5,1,0");
+            received.clear();
+            readClient(reader, received);
+        }
+        check(server.getClientCount() == 1 && server.getDroppedClientCount() == droppedBefore + 1,
+              "a client that falls 64 KiB behind is dropped");
+
+        std::string stalledData;
+        bool stalledOpen = true;
+        for (int i = 0; i < 1000 && stalledOpen; ++i)
+            stalledOpen = readClient(stalled, stalledData);
+        check(!stalledOpen, "the dropped client sees the connection closed");
+
+        received.clear();
+        server.publish("vdesk", "1");
+        readClient(reader, received);
+        check(received == "vdesk>>" + std::to_string(server.getSequence()) + ",1\n", "sequence numbers go on after a drop");
+
+        close(stalled);
+        close(reader);
+        server.stop();
+    }
+
+    void benchLogger() {
+        // No sinks: measure the facade itself, not the terminal or the disk
+        AppLog::initLogging(false, false, nullptr, "");
+        auto& logger = AppLog::getLogger();
+
+        runBenchmark("AppLog::Logger::log", 0, 0, [&] {
+            logger.log(AppLog::LVL_INFO, "workspace 42 activated on DP-1");
+        });
+
+        runBenchmark("AppLog::Logger::log/tag+category", 0, 0, [&] {
+            logger.log(AppLog::LVL_INFO, "workspace 42 activated on DP-1", std::string_view{"bench"},
+                       std::string_view{"workspace"});
+        });
+
+        // Below the runtime level: the arguments must not even be formatted
+        AppLog::setMinLevel(AppLog::LogLevel::Warn);
+        runBenchmark("AppLog::trace/filtered", 0, 0, [] {
+            AppLog::trace(AppLog::Category::VDesk, "Switched to desktop {} ({} monitors)", 2, 3);
+        });
+
+        AppLog::setCategoryEnabled(AppLog::Category::VDesk, false);
+        runBenchmark("AppLog::warn/category-disabled", 0, 0, [] {
+            AppLog::warn(AppLog::Category::VDesk, "Switched to desktop {} ({} monitors)", 2, 3);
+        });
+        AppLog::setCategoryEnabled(AppLog::Category::VDesk, true);
+        AppLog::setMinLevel(AppLog::LogLevel::Info);
+
+        runBenchmark("AppLog::info", 0, 0, [] {
+            AppLog::info(AppLog::Category::VDesk, "Switched to desktop {} ({} monitors)", 2, 3);
+        });
+
+        // Binary mode: no formatting, one record copied into the mapped file
+        const std::string binaryPath = std::format("/tmp/vdm-bench-{}.blog", getpid());
+        if (AppLog::openBinaryLog(binaryPath.c_str())) {
+            runBenchmark("AppLog::info/binary", 0, 0, [] {
+                AppLog::info(AppLog::Category::VDesk, "Switched to desktop {} ({} monitors)", 2, 3);
+            });
+
+            // Call sites with the same argument types keep their own descriptors
+            runBenchmark("AppLog::info/binary/two-sites", 0, 0, [] {
+                AppLog::info(AppLog::Category::VDesk, "Switched to desktop {} ({} monitors)", 2, 3);
+                AppLog::info(AppLog::Category::VDesk, "Left desktop {} ({} monitors)", 1, 3);
+            });
+            AppLog::closeBinaryLog();
+            std::remove(binaryPath.c_str());
+        }
+
+        // Async mode: the hot path is a single enqueue; drop rather than
+        // block so the flusher's write speed does not leak into the result
+        AppLog::initLogging(false, false, nullptr, "", {.enabled = true, .overflow = AppLog::OverflowPolicy::Drop});
+
+        runBenchmark("AppLog::Logger::log/async", 0, 0, [&] {
+            logger.log(AppLog::LVL_INFO, "workspace 42 activated on DP-1", std::string_view{"bench"},
+                       std::string_view{"workspace"});
+        });
+
+        AppLog::shutdownLogging();
+    }
+
+    // Behavior checks for code whose benchmarks would not notice a wrong result
+
+    void checkDesktopBitset() {
+        if (!isSelected("check/CDesktopBitset"))
+            return;
+
+        CDesktopBitset bits;
+        bits.resize(200);
+        check(!bits.findNext(0) && !bits.findPrev(0), "an empty bitset has no next or previous bit");
+
+        for (const size_t bit : {0, 2, 3, 70, 130, 199})
+            bits.set(bit, true);
+        check(bits.findNext(3) == 70 && bits.findNext(70) == 130, "findNext crosses words");
+        check(bits.findNext(199) == 0 && bits.findNext(150) == 199, "findNext wraps around past the last bit");
+        check(bits.findPrev(70) == 3 && bits.findPrev(130) == 70, "findPrev crosses words");
+        check(bits.findPrev(0) == 199 && bits.findPrev(1) == 0, "findPrev wraps around before the first bit");
+
+        CDesktopBitset single;
+        single.resize(200);
+        single.set(70, true);
+        check(single.findNext(70) == 70 && single.findPrev(70) == 70, "a lone bit is its own next and previous");
+
+        CDesktopBitset small;
+        small.resize(5);
+        for (const size_t bit : {0, 2, 3})
+            small.set(bit, true);
+        std::string hex;
+        small.appendHex(hex);
+        check(hex == "0xd", "appendHex puts bit 0 lowest");
+    }
+
+    void checkWorkspaceIDAllocator() {
+        if (!isSelected("check/CWorkspaceIDAllocator"))
+            return;
+
+        CWorkspaceIDAllocator ids;
+        check(ids.findFree() == 1, "an empty allocator hands out 1");
+
+        // 5000 IDs fill the first summary word (4096 IDs) and part of the next
+        for (WORKSPACEID id = 1; id <= 5000; ++id)
+            ids.markUsed(id);
+        check(ids.findFree() == 5001 && ids.getUsedCount() == 5000, "the lowest free ID follows a full summary word");
+
+        ids.markFree(4100);
+        check(ids.findFree() == 4100 && ids.findFree(4101) == 5001, "a freed ID in a full word is found again");
+
+        ids.markFree(64);
+        check(ids.findFree() == 64, "the lowest free ID wins");
+        check(ids.findFree(1, 63) == -1, "a full range has no free ID");
+
+        ids.markUsed(64);
+        ids.markUsed(4100);
+        check(ids.findFree(1, 5000) == -1 && ids.findFree(4097) == 5001, "re-used IDs mark their words full again");
+
+        ids.markUsed(0);
+        ids.markUsed(CWorkspaceIDAllocator::MAX_TRACKED_ID + 1);
+        check(ids.getUsedCount() == 5000, "IDs outside the tracked range are ignored");
+    }
+
+    void checkPerfectHash() {
+        if (!isSelected("check/CPerfectHashTable"))
+            return;
+
+        struct SEntry {
+            std::string_view name;
+            int value = 0;
+        };
+        static constexpr SEntry ENTRIES[] = {{"list", 1}, {"info", 2}, {"stats", 3}, {"trace", 4}};
+        static constexpr CPerfectHashTable TABLE{ENTRIES};
+
+        bool found = true;
+        for (const auto& entry : ENTRIES) {
+            const SEntry* hit = TABLE.find(entry.name);
+            found = found && hit && hit->value == entry.value;
+        }
+        check(found, "every name is found");
+
+        bool unknown = true;
+        for (const std::string_view name : {"", "lis", "listx", "LIST", "nope", "stats "})
+            unknown = unknown && !TABLE.find(name);
+        check(unknown, "unknown names are not found");
+
+        const std::string reply = Commands::handleCommand(FORMAT_JSON, "vdm nope");
+        check(reply.starts_with("{\"error\": \"usage: vdm <"), "an unknown subcommand gets the usage");
+    }
+
+    void checkSerializer() {
+        if (!isSelected("check/CSerializer"))
+            return;
+
+        std::string json;
+        CSerializer out(json, FORMAT_JSON);
+        out.beginObject();
+        out.field("name", std::string_view("a\"b\\c\nd\te\x01"));
+        out.field("count", 3);
+        out.endObject();
+        check(json == R"({"name": "a\"b\\c\nd\te\u0001", "count": 3})", "JSON strings are escaped");
+
+        std::string plain;
+        CSerializer text(plain, FORMAT_NORMAL);
+        text.beginObject();
+        text.field("name", std::string_view("a\"b"));
+        text.endObject();
+        check(plain.find("a\"b") != std::string::npos, "plain text is not escaped");
+    }
+
+    void checkListQuery() {
+        if (!isSelected("check/vdm list"))
+            return;
+
+        CMockBackend backend;
+        populate(backend, 2, 2);
+
+        auto* manager = CWorkspaceManager::getInstance();
+        manager->initialize(&backend);
+        auto& desktops = CVirtualDesktopManager::getInstance();
+        desktops.initialize(&backend);
+
+        // Desktop 2 has a window on DP-2 only; desktop 1 is empty and active
+        desktops.switchToDesktop(2);
+        const WORKSPACEID occupiedID = desktops.getLayout().getWorkspaceID(2, 1);
+        backend.openWindow(occupiedID);
+        desktops.switchToDesktop(1);
+
+        const uint64_t generation = desktops.getGeneration();
+        const std::string head = "{\"generation\": " + std::to_string(generation) + ", \"active\": 1";
+        auto list = [](std::string_view args) { return Commands::handleCommand(FORMAT_JSON, "vdm list " + std::string(args)); };
+
+        check(list("fields=id occupied=1") == head + ", \"desktops\": [{\"id\": 2}]}", "occupied=1 keeps occupied desktops");
+        check(list("fields=id desktop=active") == head + ", \"desktops\": [{\"id\": 1}]}", "desktop=active selects the active desktop");
+        check(list("fields=id desktop=2") == head + ", \"desktops\": [{\"id\": 2}]}", "desktop=N selects one desktop");
+        check(list("fields=occupied") == head + ", \"occupied\": \"0x2\"}", "fields=occupied reports the occupancy mask");
+        check(list("fields=occupied monitor=DP-1") == head + ", \"occupied\": \"0x0\"}", "monitor= restricts occupancy");
+        check(list("fields=none") == head + "}", "fields=none leaves only the header");
+        check(list("fields=workspaces desktop=2 monitor=DP-2") ==
+                  head + ", \"desktops\": [{\"workspaces\": [" + std::to_string(occupiedID) + "]}]}",
+              "monitor= restricts workspaces");
+
+        check(list("since=" + std::to_string(generation)) ==
+                  "{\"generation\": " + std::to_string(generation) + ", \"unchanged\": true}",
+              "since=<current generation> replies unchanged");
+        check(list("since=" + std::to_string(generation - 1)).find("\"desktops\"") != std::string::npos,
+              "since=<older generation> gets the full listing");
+
+        for (const std::string_view args : {"bad", "fields=", "fields=bogus", "fields=id,bogus", "desktop=0", "desktop=x",
+                                            "occupied=2", "since=", "since=x", "monitor=", "monitor=HDMI-A-9"}) {
+            const std::string what = "vdm list " + std::string(args) + " is rejected";
+            check(list(args).starts_with("{\"error\": "), what.c_str());
+        }
+        check(list("bad") == "{\"error\": \"invalid argument 'bad'\"}", "the error names the invalid argument");
+
+        desktops.shutdown();
+        CWorkspaceManager::destroy();
+    }
+
+    /**
+     * Write a binary log of known records; the vdm-logdecode-roundtrip test
+     * checks what the decoder renders from it
+     */
+    void writeCheckLog(const std::string& path) {
+        AppLog::initLogging(false, false, nullptr, "");
+        if (!check(AppLog::openBinaryLog(path.c_str()), "binary log opens"))
+            return;
+
+        AppLog::info(AppLog::Category::VDesk, "Switched to desktop {} ({} monitors)", 2, 3);
+        AppLog::warn(AppLog::Category::Events, "Dropped client {} after {} bytes", std::string_view{"waybar"}, 65536u);
+        AppLog::error(AppLog::Category::General, "Moved {} windows: {}, mode {}, ratio {:.1f}", -4, true, 'x', 0.5);
+
+        AppLog::closeBinaryLog();
+        AppLog::shutdownLogging();
+    }
+
+    std::string jsonEscape(std::string_view in) {
+        std::string out;
+        for (const char c : in) {
+            if (c == '"' || c == '\\')
+                out.push_back('\\');
+            out.push_back(c);
+        }
+        return out;
+    }
+
+    bool writeJson(const std::string& path) {
+        FILE* f = std::fopen(path.c_str(), "w");
+        if (!f)
+            return false;
+
+        std::fprintf(f, "{\n  \"plugin\": \"%s\",\n  \"version\": \"%s\",\n  \"benchmarks\": [\n", PLUGIN_NAME, PLUGIN_VERSION);
+        for (size_t i = 0; i < gResults.size(); ++i) {
+            const auto& r = gResults[i];
+            std::fprintf(f,
+                         "    {\"name\": \"%s\", \"workspaces\": %d, \"monitors\": %d, \"iterations\": %llu, "
+                         "\"ns_per_op\": %.2f, \"allocs_per_op\": %.3f, \"bytes_per_op\": %.1f}%s\n",
+                         jsonEscape(r.name).c_str(), r.workspaces, r.monitors, (unsigned long long)r.iterations,
+                         r.nsPerOp, r.allocsPerOp, r.bytesPerOp, i + 1 < gResults.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        std::fclose(f);
+        return true;
+    }
+
+    void usage(const char* argv0) {
+        std::fprintf(stderr, "Usage: %s [--filter SUBSTR] [--min-time-ms N] [--json PATH] [--check] [--check-log PATH]\n",
+                     argv0);
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc)
+            gConfig.filter = argv[++i];
+        else if (arg == "--min-time-ms" && i + 1 < argc)
+            gConfig.minTimeMs = std::atoi(argv[++i]);
+        else if (arg == "--json" && i + 1 < argc)
+            gConfig.jsonPath = argv[++i];
+        else if (arg == "--check")
+            gConfig.checkOnly = true;
+        else if (arg == "--check-log" && i + 1 < argc)
+            gConfig.checkLogPath = argv[++i];
+        else {
+            usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    Stats::setAllocationCounter([] { return gAllocCount.load(std::memory_order_relaxed); });
+
+    std::printf("%-48s %6s %4s %12s %10s %12s\n", "benchmark", "ws", "mon", "ns/op", "allocs/op", "bytes/op");
+
+    constexpr int WORKSPACE_COUNTS[] = {10, 100, 1000};
+    constexpr int MONITOR_COUNTS[] = {1, 3, 8};
+
+    for (const int workspaces : WORKSPACE_COUNTS) {
+        for (const int monitors : MONITOR_COUNTS)
+            benchWorkspaceManager(workspaces, monitors);
+    }
+
+    for (const int monitors : MONITOR_COUNTS)
+        benchVirtualDesktop(monitors);
+
+    for (const int monitors : MONITOR_COUNTS)
+        benchLayout(monitors);
+
+    for (const int monitors : MONITOR_COUNTS)
+        benchDesktopSwitch(monitors);
+
+    benchNotifications();
+    benchCommands();
+    benchStats();
+    benchTrace();
+    benchEventServer();
+    benchLogger();
+
+    checkDesktopBitset();
+    checkWorkspaceIDAllocator();
+    checkPerfectHash();
+    checkSerializer();
+    checkListQuery();
+    if (!gConfig.checkLogPath.empty())
+        writeCheckLog(gConfig.checkLogPath);
+
+    if (!gConfig.jsonPath.empty() && !writeJson(gConfig.jsonPath)) {
+        std::fprintf(stderr, "Failed to write %s\n", gConfig.jsonPath.c_str());
+        return 1;
+    }
+
+    return gCheckFailed ? 1 : 0;
+}
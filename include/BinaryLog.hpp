@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+// Binary deferred-format log mode
+//
+// Instead of formatting, each call site of the formatted AppLog API registers
+// a format descriptor once and then only writes a compact record (type, site
+// ID, timestamp, raw arguments) into a memory-mapped file. vdm-logdecode turns
+// the file back into "[category] [tag] msg" text.
+//
+// File layout, all integers little-endian:
+//   header   "VDMBLOG1", u64 realtime ns at open, u64 steady ns at open,
+//            u16 tag length, tag
+//   records  u8 RECORD_SITE: u32 site, u8 level, u16 category length,
+//                            category, u16 format length, format,
+//                            u8 argument count, u8 type per argument
+//            u8 RECORD_LOG:  u32 site, u64 steady ns, arguments
+//   A zero byte means the rest of the current CHUNK_SIZE chunk is unused.
+namespace AppLog::binary {
+
+    constexpr char MAGIC[8] = {'V', 'D', 'M', 'B', 'L', 'O', 'G', '1'};
+    constexpr size_t CHUNK_SIZE = 4 * 1024 * 1024;
+
+    enum RecordType : uint8_t {
+        RECORD_END = 0,
+        RECORD_SITE = 1,
+        RECORD_LOG = 2
+    };
+
+    // Arguments are stored raw: 8 bytes for numbers, 1 for bool and char,
+    // u16 length + bytes for strings. Anything else is formatted with "{}"
+    // at the call site and stored as a string.
+    enum class ArgType : uint8_t { Int, UInt, Float, Bool, Char, String };
+
+    constexpr size_t MAX_STRING = UINT16_MAX;
+
+    /**
+     * One call site: a format string at a level and category
+     */
+    struct Site {
+        uint32_t id = 0;
+        uint8_t level = 0;
+        std::string_view category;
+        std::string_view format;
+        const ArgType* types = nullptr;
+        uint8_t argCount = 0;
+
+        // File the descriptor was last written to, see write()
+        std::atomic<uint32_t> epoch{0};
+    };
+
+    namespace detail {
+        extern std::atomic<bool> gActive;
+        extern std::atomic<uint32_t> gEpoch;
+
+        // Space for one record, nullptr if the file cannot take it. Holds the
+        // writer lock until commit()
+        std::byte* reserve(size_t size);
+        void commit();
+
+        void defineSite(Site& site);
+        uint64_t now();
+
+        template <typename T>
+        constexpr ArgType argType() {
+            if constexpr (std::same_as<T, bool>)
+                return ArgType::Bool;
+            else if constexpr (std::same_as<T, char>)
+                return ArgType::Char;
+            else if constexpr (std::signed_integral<T>)
+                return ArgType::Int;
+            else if constexpr (std::unsigned_integral<T>)
+                return ArgType::UInt;
+            else if constexpr (std::floating_point<T>)
+                return ArgType::Float;
+            else
+                return ArgType::String;
+        }
+
+        template <typename... Args>
+        inline constexpr std::array<ArgType, sizeof...(Args)> ARG_TYPES = {argType<Args>()...};
+
+        // What gets written for an argument: numbers by value, strings as views,
+        // anything else formatted now
+        template <typename T>
+        auto toStored(const T& value) {
+            if constexpr (argType<T>() != ArgType::String)
+                return value;
+            else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+                return std::string_view{value};
+            else
+                return std::format("{}", value);
+        }
+
+        template <typename T>
+        size_t storedSize(const T& value) {
+            if constexpr (std::same_as<T, bool> || std::same_as<T, char>)
+                return 1;
+            else if constexpr (std::is_arithmetic_v<T>)
+                return 8;
+            else
+                return 2 + std::min(std::string_view{value}.size(), MAX_STRING);
+        }
+
+        template <typename T>
+        std::byte* encode(std::byte* out, const T& value) {
+            if constexpr (std::same_as<T, bool> || std::same_as<T, char>) {
+                *out = static_cast<std::byte>(value);
+                return out + 1;
+            } else if constexpr (std::is_arithmetic_v<T>) {
+                using Wide = std::conditional_t<std::floating_point<T>, double,
+                                                std::conditional_t<std::signed_integral<T>, int64_t, uint64_t>>;
+                const Wide wide = static_cast<Wide>(value);
+                std::memcpy(out, &wide, 8);
+                return out + 8;
+            } else {
+                const std::string_view view{value};
+                const uint16_t length = static_cast<uint16_t>(std::min(view.size(), MAX_STRING));
+                std::memcpy(out, &length, 2);
+                std::memcpy(out + 2, view.data(), length);
+                return out + 2 + length;
+            }
+        }
+    }
+
+    inline bool isActive() { return detail::gActive.load(std::memory_order_relaxed); }
+
+    /**
+     * Find or create the site for a format string
+     * @return Site, valid for the lifetime of the process
+     */
+    Site* registerSite(uint8_t level, std::string_view category, std::string_view format, const ArgType* types,
+                       uint8_t argCount);
+
+    /**
+     * Start writing records to a file, replacing it if it exists
+     * @param tag Default tag rendered by the decoder
+     * @return false if the file cannot be created or mapped
+     */
+    bool open(const char* path, std::string_view tag);
+
+    /**
+     * Stop writing and trim the file to the data actually written
+     */
+    void close();
+
+    template <typename... Args>
+    void write(Site& site, const Args&... args) {
+        if (site.epoch.load(std::memory_order_relaxed) != detail::gEpoch.load(std::memory_order_relaxed))
+            detail::defineSite(site);
+
+        const auto stored = std::make_tuple(detail::toStored(args)...);
+        const size_t size = std::apply([](const auto&... v) { return (size_t{1 + 4 + 8} + ... + detail::storedSize(v)); }, stored);
+
+        std::byte* out = detail::reserve(size);
+        if (!out)
+            return;
+
+        *out++ = static_cast<std::byte>(RECORD_LOG);
+        std::memcpy(out, &site.id, 4);
+        const uint64_t timestamp = detail::now();
+        std::memcpy(out + 4, &timestamp, 8);
+        out += 12;
+        std::apply([&out](const auto&... v) { ((out = detail::encode(out, v)), ...); }, stored);
+
+        detail::commit();
+    }
+
+} // namespace AppLog::binary
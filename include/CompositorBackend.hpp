@@ -0,0 +1,243 @@
+#pragma once
+
+#include "VdmTypes.hpp"
+#include "FunctionRef.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace VDM {
+
+// Opaque window handle, stable for the lifetime of the window
+typedef uint64_t WINDOWID;
+
+/**
+ * @brief Snapshot of a monitor as seen by the compositor
+ */
+struct SMonitorState {
+    MONITORID id = -1;
+    std::string name;
+    std::string description;
+    int32_t width = 0;
+    int32_t height = 0;
+    float refreshRate = 0.f;
+    int32_t x = 0;
+    int32_t y = 0;
+    WORKSPACEID activeWorkspaceID = -1;
+};
+
+/**
+ * @brief Snapshot of a workspace as seen by the compositor
+ */
+struct SWorkspaceState {
+    WORKSPACEID id = -1;
+    std::string name;
+    MONITORID monitorID = -1;
+};
+
+/**
+ * @brief Snapshot of a mapped window as seen by the compositor
+ */
+struct SWindowState {
+    WINDOWID id = 0;
+    WORKSPACEID workspaceID = -1;
+    bool fullscreen = false;
+    bool urgent = false;
+};
+
+/**
+ * @brief Non-owning view of a monitor
+ *
+ * Strings point into compositor state: valid until the next compositor
+ * event or mutation, so views are consumed within the visitor or query call.
+ */
+struct SMonitorView {
+    MONITORID id = -1;
+    std::string_view name;
+    std::string_view description;
+    int32_t width = 0;
+    int32_t height = 0;
+    float refreshRate = 0.f;
+    int32_t x = 0;
+    int32_t y = 0;
+    WORKSPACEID activeWorkspaceID = -1;
+};
+
+/**
+ * @brief Non-owning view of a workspace, same lifetime rules as SMonitorView
+ */
+struct SWorkspaceView {
+    WORKSPACEID id = -1;
+    std::string_view name;
+    MONITORID monitorID = -1;
+};
+
+/**
+ * @brief One monitor's target workspace in a multi-monitor switch
+ */
+struct SWorkspaceAssignment {
+    MONITORID monitorID = -1;
+    WORKSPACEID workspaceID = -1;
+};
+
+/**
+ * @brief Severity of a user-facing notification
+ */
+enum eNotifyLevel : uint8_t {
+    NOTIFY_OK = 0,
+    NOTIFY_WARN,
+    NOTIFY_ERROR
+};
+
+/**
+ * @brief Receiver of compositor events
+ *
+ * All callbacks have empty default implementations so listeners only
+ * override what they care about. Events are delivered on the compositor thread.
+ */
+class IBackendListener {
+public:
+    virtual ~IBackendListener() = default;
+
+    virtual void onMonitorAdded(const SMonitorState& /*monitor*/) {}
+    virtual void onMonitorRemoved(MONITORID /*id*/) {}
+    virtual void onWorkspaceCreated(const SWorkspaceState& /*workspace*/) {}
+    virtual void onWorkspaceDestroyed(WORKSPACEID /*id*/) {}
+    virtual void onWorkspaceMoved(WORKSPACEID /*id*/, MONITORID /*monitorID*/) {}
+    virtual void onWorkspaceActivated(MONITORID /*monitorID*/, WORKSPACEID /*id*/) {}
+
+    virtual void onWindowOpened(const SWindowState& /*window*/) {}
+    virtual void onWindowClosed(WINDOWID /*id*/) {}
+    virtual void onWindowMoved(WINDOWID /*id*/, WORKSPACEID /*workspaceID*/) {}
+    virtual void onWindowFullscreen(WINDOWID /*id*/, bool /*fullscreen*/) {}
+    virtual void onWindowUrgent(WINDOWID /*id*/, bool /*urgent*/) {}
+};
+
+/**
+ * @brief Compositor-facing interface used by the VDM core
+ *
+ * Everything the core needs from the compositor goes through this interface:
+ * state queries, workspace mutations, notifications and events. The plugin
+ * uses CHyprlandBackend; CMockBackend simulates monitors, workspaces and
+ * windows in memory so the core can run and be profiled off-Hyprland.
+ */
+class ICompositorBackend {
+public:
+    virtual ~ICompositorBackend() = default;
+
+    // State queries
+
+    /**
+     * @brief All monitors, in compositor order
+     */
+    virtual std::vector<SMonitorState> getMonitors() = 0;
+
+    /**
+     * @brief All workspaces, in compositor order
+     */
+    virtual std::vector<SWorkspaceState> getWorkspaces() = 0;
+
+    virtual std::optional<SMonitorState> getMonitor(MONITORID id) = 0;
+    virtual std::optional<SWorkspaceState> getWorkspace(WORKSPACEID id) = 0;
+
+    /**
+     * @brief Visit all monitors, in compositor order, without copying them
+     */
+    virtual void forEachMonitor(CFunctionRef<void(const SMonitorView&)> fn) = 0;
+
+    /**
+     * @brief Visit all workspaces, in compositor order, without copying them
+     */
+    virtual void forEachWorkspace(CFunctionRef<void(const SWorkspaceView&)> fn) = 0;
+
+    virtual std::optional<SMonitorView> getMonitorView(MONITORID id) = 0;
+    virtual std::optional<SWorkspaceView> getWorkspaceView(WORKSPACEID id) = 0;
+
+    /**
+     * @brief All mapped windows, in a single pass over the compositor list
+     *
+     * Used to seed and verify the window counters; queries read the
+     * counters instead.
+     */
+    virtual std::vector<SWindowState> getWindows() = 0;
+
+    /**
+     * @brief Look up a monitor by its connector name
+     * @return Monitor ID, or -1 if not found
+     */
+    virtual MONITORID getMonitorIDByName(std::string_view name) = 0;
+
+    /**
+     * @brief Monitor under the cursor, falling back to the first monitor
+     * @return Monitor ID, or -1 if there are no monitors
+     */
+    virtual MONITORID getFocusedMonitorID() = 0;
+
+    /**
+     * @brief Workspace currently shown on a monitor
+     * @return Workspace ID, or -1 if none
+     */
+    virtual WORKSPACEID getActiveWorkspaceID(MONITORID monitorID) = 0;
+
+    /**
+     * @brief Name of the current tiling layout, "unknown" if not available
+     */
+    virtual std::string getCurrentLayout() = 0;
+
+    // Mutations
+
+    virtual bool createWorkspace(WORKSPACEID id, MONITORID monitorID, const std::string& name) = 0;
+    virtual bool changeWorkspace(MONITORID monitorID, WORKSPACEID id) = 0;
+
+    /**
+     * @brief Show several workspaces at once, as a single transaction
+     *
+     * Every monitor is switched before anything is announced: layout
+     * recalculation, focus and workspace events are flushed once at the end,
+     * after the whole set has been applied. Nothing changes if an assignment
+     * refers to an unknown monitor or workspace.
+     * @param animate false to show the workspaces without the switch animation
+     */
+    virtual bool changeWorkspaces(std::span<const SWorkspaceAssignment> assignments, bool animate) = 0;
+    virtual bool moveWorkspaceToMonitor(WORKSPACEID id, MONITORID monitorID) = 0;
+    virtual bool renameWorkspace(WORKSPACEID id, const std::string& name) = 0;
+
+    /**
+     * @brief Let go of workspaces that are no longer needed
+     *
+     * Each workspace that is empty and not on screen is destroyed, and
+     * reported through onWorkspaceDestroyed; the others are left alone.
+     */
+    virtual void releaseWorkspaces(std::span<const WORKSPACEID> ids) = 0;
+
+    // User feedback
+
+    virtual void notify(const std::string& message, eNotifyLevel level, int durationMs) = 0;
+
+    // Event subscription
+
+    void addListener(IBackendListener* listener) {
+        if (std::find(m_listeners.begin(), m_listeners.end(), listener) == m_listeners.end())
+            m_listeners.push_back(listener);
+    }
+
+    void removeListener(IBackendListener* listener) {
+        std::erase(m_listeners, listener);
+    }
+
+protected:
+    template <typename Fn>
+    void emit(Fn&& fn) {
+        for (auto* listener : m_listeners)
+            fn(*listener);
+    }
+
+private:
+    std::vector<IBackendListener*> m_listeners;
+};
+
+} // namespace VDM
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace VDM {
+
+/**
+ * @brief Growable bitset over desktop indices
+ *
+ * Finding the next or previous set bit scans 64 desktops per word with
+ * std::countr_zero / std::countl_zero, so navigation does not depend on the
+ * desktop count in practice, nor on how many windows the desktops hold.
+ */
+class CDesktopBitset {
+public:
+    static constexpr size_t WORD_BITS = 64;
+
+    /**
+     * @brief Grow or shrink to @p bits bits; new bits are clear
+     */
+    void resize(size_t bits) {
+        m_words.resize((bits + WORD_BITS - 1) / WORD_BITS, 0);
+        if (bits < m_size && bits % WORD_BITS != 0)
+            m_words.back() &= lowMask(bits % WORD_BITS);
+        m_size = bits;
+    }
+
+    size_t size() const { return m_size; }
+
+    bool test(size_t bit) const { return bit < m_size && (m_words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1; }
+
+    void set(size_t bit, bool value) {
+        if (bit >= m_size)
+            return;
+
+        const uint64_t mask = uint64_t{1} << (bit % WORD_BITS);
+        if (value)
+            m_words[bit / WORD_BITS] |= mask;
+        else
+            m_words[bit / WORD_BITS] &= ~mask;
+    }
+
+    bool any() const { return std::ranges::any_of(m_words, [](uint64_t word) { return word != 0; }); }
+
+    /**
+     * @brief First set bit after @p from, wrapping around; @p from itself comes last
+     * @return Bit index, nullopt if no bit is set
+     */
+    std::optional<size_t> findNext(size_t from) const {
+        if (from + 1 < m_size) {
+            if (auto bit = findFirst(from + 1, m_size))
+                return bit;
+        }
+        return findFirst(0, std::min(from + 1, m_size));
+    }
+
+    /**
+     * @brief Last set bit before @p from, wrapping around; @p from itself comes last
+     * @return Bit index, nullopt if no bit is set
+     */
+    std::optional<size_t> findPrev(size_t from) const {
+        if (auto bit = findLast(0, std::min(from, m_size)))
+            return bit;
+        return findLast(std::min(from, m_size), m_size);
+    }
+
+    /**
+     * @brief Append the bits as a hex number, bit 0 lowest: desktops 1, 3 and 4 give "0xd"
+     * @param hex Any string-like buffer, e.g. a std::pmr::string from the request arena
+     */
+    template <typename String>
+    void appendHex(String& hex) const {
+        static constexpr char DIGITS[] = "0123456789abcdef";
+
+        hex += "0x";
+        bool leading = true;
+        for (size_t word = m_words.size(); word-- > 0;) {
+            for (int shift = static_cast<int>(WORD_BITS) - 4; shift >= 0; shift -= 4) {
+                const unsigned digit = (m_words[word] >> shift) & 0xf;
+                if (leading && digit == 0)
+                    continue;
+                leading = false;
+                hex.push_back(DIGITS[digit]);
+            }
+        }
+        if (leading)
+            hex.push_back('0');
+    }
+
+    std::span<const uint64_t> getWords() const { return m_words; }
+
+private:
+    static uint64_t lowMask(size_t bits) { return bits >= WORD_BITS ? ~uint64_t{0} : (uint64_t{1} << bits) - 1; }
+
+    // Word of bits [begin, end) that lie in word `word`, others cleared
+    uint64_t maskedWord(size_t word, size_t begin, size_t end) const {
+        const size_t base = word * WORD_BITS;
+        uint64_t bits = m_words[word];
+        if (begin > base)
+            bits &= ~lowMask(begin - base);
+        if (end < base + WORD_BITS)
+            bits &= lowMask(end - base);
+        return bits;
+    }
+
+    std::optional<size_t> findFirst(size_t begin, size_t end) const {
+        if (begin >= end)
+            return std::nullopt;
+
+        for (size_t word = begin / WORD_BITS; word * WORD_BITS < end; ++word) {
+            if (const uint64_t bits = maskedWord(word, begin, end))
+                return word * WORD_BITS + std::countr_zero(bits);
+        }
+        return std::nullopt;
+    }
+
+    std::optional<size_t> findLast(size_t begin, size_t end) const {
+        if (begin >= end)
+            return std::nullopt;
+
+        for (size_t word = (end - 1) / WORD_BITS + 1; word-- > begin / WORD_BITS;) {
+            if (const uint64_t bits = maskedWord(word, begin, end))
+                return word * WORD_BITS + (WORD_BITS - 1 - std::countl_zero(bits));
+        }
+        return std::nullopt;
+    }
+
+    std::vector<uint64_t> m_words;
+    size_t m_size = 0;
+};
+
+} // namespace VDM
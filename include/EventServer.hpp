@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace VDM {
+
+    /**
+     * @brief Pushes virtual desktop events to clients over a Unix socket
+     *
+     * Events are written as lines of the form `EVENT>>SEQ,DATA`: Hyprland's
+     * socket2 framing with a sequence number in front of the data. Sequence
+     * numbers go up by one per event, so a client can tell it missed some.
+     *
+     * All sockets are non-blocking and the server never waits on a client.
+     * It keeps its listening socket and its clients in an epoll set; the
+     * caller watches getFD() in its event loop and calls dispatch() when it
+     * is readable. Each client has a bounded send queue, and a client that
+     * falls more than MAX_QUEUED_BYTES behind is disconnected.
+     */
+    class CEventServer {
+    public:
+        static constexpr size_t MAX_QUEUED_BYTES = 64 * 1024;
+
+        CEventServer();
+        ~CEventServer();
+
+        CEventServer(const CEventServer&) = delete;
+        CEventServer& operator=(const CEventServer&) = delete;
+
+        /**
+         * @brief Socket path of the running Hyprland instance
+         * @return $XDG_RUNTIME_DIR/hypr/<signature>/.vdm.sock, nullopt if the
+         *         environment does not name an instance
+         */
+        static std::optional<std::string> getDefaultPath();
+
+        /**
+         * @brief Listen on a socket path, replacing a stale socket file
+         * @return false if the socket could not be set up
+         */
+        bool start(const std::string& path);
+
+        /**
+         * @brief Disconnect every client and remove the socket file
+         */
+        void stop();
+
+        bool isRunning() const { return m_listenFD != -1; }
+
+        /**
+         * @brief Epoll FD to watch for readability, -1 when not running
+         */
+        int getFD() const { return m_epollFD; }
+
+        /**
+         * @brief Accept new clients, flush pending output and reap hung-up clients
+         *
+         * Never blocks.
+         */
+        void dispatch();
+
+        /**
+         * @brief Queue an event for every client
+         * @param event Event name, e.g. "vdesk"
+         * @param data Comma-separated payload, without the sequence number
+         */
+        void publish(std::string_view event, std::string_view data);
+
+        size_t getClientCount() const { return m_clients.size(); }
+
+        /**
+         * @brief Sequence number of the last published event, 0 if none
+         */
+        uint64_t getSequence() const { return m_sequence; }
+
+        /**
+         * @brief Number of clients disconnected for not keeping up
+         */
+        uint64_t getDroppedClientCount() const { return m_droppedClients; }
+
+    private:
+        struct SClient {
+            int fd = -1;
+            std::string queue;
+            size_t offset = 0;
+            bool wantWrite = false;
+        };
+
+        void acceptClients();
+
+        /**
+         * @brief Write as much of a client's queue as the socket takes
+         * @return false if the connection is broken
+         */
+        bool flush(SClient& client);
+
+        /**
+         * @brief Watch a client for writability only while it has queued output
+         */
+        void updateInterest(SClient& client);
+
+        SClient* findClient(int fd);
+        void dropClient(int fd);
+
+        std::string m_path;
+        int m_listenFD = -1;
+        int m_epollFD = -1;
+        std::vector<SClient> m_clients;
+
+        uint64_t m_sequence = 0;
+        uint64_t m_droppedClients = 0;
+
+        // Reused between events so that publishing does not allocate
+        std::string m_line;
+    }; // class CEventServer
+
+} // namespace VDM
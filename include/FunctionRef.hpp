@@ -0,0 +1,40 @@
+#pragma once
+
+#include <concepts>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace VDM {
+
+template <typename Signature>
+class CFunctionRef;
+
+/**
+ * @brief Non-owning reference to a callable, for visitor parameters
+ *
+ * Unlike std::function it never allocates and can cross a virtual call:
+ * it is a pointer to the callable plus a trampoline. The callable must
+ * outlive the reference, which holds for the usual
+ * `backend->forEachWorkspace([&](const auto& ws) { ... })` pattern.
+ */
+template <typename R, typename... Args>
+class CFunctionRef<R(Args...)> {
+public:
+    template <typename Fn>
+        requires(!std::same_as<std::remove_cvref_t<Fn>, CFunctionRef> && std::is_invocable_r_v<R, Fn&, Args...>)
+    CFunctionRef(Fn&& fn) // NOLINT: implicit by design, like std::function
+        : m_pObject(const_cast<void*>(static_cast<const void*>(std::addressof(fn)))),
+          m_pCall([](void* object, Args... args) -> R {
+              return std::invoke(*static_cast<std::remove_reference_t<Fn>*>(object), std::forward<Args>(args)...);
+          }) {}
+
+    R operator()(Args... args) const { return m_pCall(m_pObject, std::forward<Args>(args)...); }
+
+private:
+    void* m_pObject;
+    R (*m_pCall)(void*, Args...);
+};
+
+} // namespace VDM
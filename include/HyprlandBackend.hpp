@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CompositorBackend.hpp"
+
+#include <hyprland/src/plugins/PluginAPI.hpp>
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/desktop/Workspace.hpp>
+#include <hyprland/src/helpers/Monitor.hpp>
+#include <hyprland/src/desktop/Window.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace VDM {
+
+/**
+ * @brief ICompositorBackend implementation backed by the running Hyprland instance
+ *
+ * Translates Hyprland hook events into IBackendListener callbacks and keeps
+ * weak references to workspaces and monitors so lookups by ID do not walk
+ * the compositor lists.
+ */
+class CHyprlandBackend : public ICompositorBackend {
+public:
+    explicit CHyprlandBackend(HANDLE handle);
+    ~CHyprlandBackend() override;
+
+    CHyprlandBackend(const CHyprlandBackend&) = delete;
+    CHyprlandBackend& operator=(const CHyprlandBackend&) = delete;
+
+    /**
+     * @brief Register the Hyprland event callbacks and cache the current state
+     */
+    void init();
+
+    std::vector<SMonitorState> getMonitors() override;
+    std::vector<SWorkspaceState> getWorkspaces() override;
+    std::optional<SMonitorState> getMonitor(MONITORID id) override;
+    std::optional<SWorkspaceState> getWorkspace(WORKSPACEID id) override;
+    void forEachMonitor(CFunctionRef<void(const SMonitorView&)> fn) override;
+    void forEachWorkspace(CFunctionRef<void(const SWorkspaceView&)> fn) override;
+    std::optional<SMonitorView> getMonitorView(MONITORID id) override;
+    std::optional<SWorkspaceView> getWorkspaceView(WORKSPACEID id) override;
+    std::vector<SWindowState> getWindows() override;
+    MONITORID getMonitorIDByName(std::string_view name) override;
+    MONITORID getFocusedMonitorID() override;
+    WORKSPACEID getActiveWorkspaceID(MONITORID monitorID) override;
+    std::string getCurrentLayout() override;
+
+    bool createWorkspace(WORKSPACEID id, MONITORID monitorID, const std::string& name) override;
+    bool changeWorkspace(MONITORID monitorID, WORKSPACEID id) override;
+    bool changeWorkspaces(std::span<const SWorkspaceAssignment> assignments, bool animate) override;
+    bool moveWorkspaceToMonitor(WORKSPACEID id, MONITORID monitorID) override;
+    bool renameWorkspace(WORKSPACEID id, const std::string& name) override;
+    void releaseWorkspaces(std::span<const WORKSPACEID> ids) override;
+
+    void notify(const std::string& message, eNotifyLevel level, int durationMs) override;
+
+private:
+    void registerCallbacks();
+
+    PHLWORKSPACE getWorkspaceByID(WORKSPACEID id);
+    PHLMONITOR getMonitorByID(MONITORID id);
+
+    static SMonitorState toState(const PHLMONITOR& monitor);
+    static SWorkspaceState toState(const PHLWORKSPACE& workspace);
+    static SWindowState toState(const PHLWINDOW& window);
+    static SMonitorView toView(const PHLMONITOR& monitor);
+    static SWorkspaceView toView(const PHLWORKSPACE& workspace);
+
+    /**
+     * @brief Stable handle for a window: the address of its CWindow
+     */
+    static WINDOWID windowID(const PHLWINDOW& window) { return reinterpret_cast<uintptr_t>(window.get()); }
+
+    HANDLE m_hHandle;
+
+    // Event callbacks, kept alive for as long as the backend exists
+    std::vector<SP<HOOK_CALLBACK_FN>> m_vCallbacks;
+
+    // Lookup caches, maintained from the same events that feed the listeners
+    std::unordered_map<WORKSPACEID, PHLWORKSPACEREF> m_workspaceRefs;
+    std::unordered_map<MONITORID, PHLMONITORREF> m_monitorRefs;
+
+    // Workspaces created by the plugin, kept alive while VDM owns them
+    std::unordered_map<WORKSPACEID, PHLWORKSPACE> m_ownedWorkspaces;
+};
+
+} // namespace VDM
@@ -1,20 +1,174 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+#include "DesktopBitset.hpp"
 #include "VirtualDesktop.hpp"
 
 namespace VDM {
 
+    /**
+     * @brief Set of virtual desktops spanning all monitors
+     *
+     * Each monitor gets a slot; a desktop maps every slot to one workspace.
+     * Slots are keyed by monitor name, so a monitor that is unplugged and
+     * plugged back in returns to its old slot and workspaces.
+     *
+     * The mapping is a dense [desktop][slot] matrix of workspace IDs, one row
+     * per desktop, so showing a desktop reads a single row. A reverse index
+     * maps every assigned workspace to its cell, so finding the desktop that
+     * owns a workspace is one hash lookup. A workspace is assigned to at most
+     * one cell: assigning it elsewhere clears the old cell.
+     *
+     * Occupancy, whether a cell's workspace holds windows, is kept as one
+     * bitset over desktop indices per slot plus one for all slots. The owner
+     * keeps it up to date; the layout only sizes the bitsets.
+     */
     class CLayout {
     public:
+        /**
+         * @brief Position of a workspace in the matrix
+         */
+        struct SCell {
+            uint32_t desktop = 0; // Index into getDesktops()
+            uint32_t slot = 0;
+        };
+
         CLayout();
         ~CLayout();
 
+        // The desktops' row views point into the matrix: a copy would still
+        // point into the original, a move takes the buffer along
+        CLayout(const CLayout&) = delete;
+        CLayout& operator=(const CLayout&) = delete;
+        CLayout(CLayout&&) noexcept = default;
+        CLayout& operator=(CLayout&&) noexcept = default;
+
+        // Desktops
+
+        /**
+         * @brief Append a new desktop with all slots unassigned
+         * @return Reference to the new desktop, valid until the next desktop is added
+         */
+        CVirtualDesktop& createDesktop(std::optional<std::string_view> name = std::nullopt);
+
+        /**
+         * @brief Find a desktop by ID
+         * @return Pointer to the desktop, nullptr if not found
+         */
+        CVirtualDesktop* findDesktop(const int id);
+        const CVirtualDesktop* findDesktop(const int id) const;
+
+        /**
+         * @brief Find the desktop owning a workspace
+         * @return Pointer to the desktop, nullptr if the workspace is not owned by any desktop
+         */
+        CVirtualDesktop* findDesktopByWorkspace(const WORKSPACEID id);
+
+        /**
+         * @brief Cell a workspace is assigned to
+         * @return Cell, nullopt if the workspace is not owned by any desktop
+         */
+        std::optional<SCell> findWorkspace(const WORKSPACEID id) const;
+
+        const std::vector<CVirtualDesktop>& getDesktops() const { return m_virtualDesktops; }
+        size_t getDesktopCount() const { return m_virtualDesktops.size(); }
+
+        CVirtualDesktop* getActiveDesktop() { return findDesktop(m_activeDesktopID); }
+        int getActiveDesktopID() const { return m_activeDesktopID; }
+        void setActiveDesktopID(const int id);
+
+        // Workspace assignment
+
+        /**
+         * @brief Workspace of a desktop on a slot
+         * @return Workspace ID, -1 if unassigned or out of range
+         */
+        WORKSPACEID getWorkspaceID(const int desktopID, const size_t slot) const;
+
+        /**
+         * @brief Assign a workspace to a desktop's slot, -1 to clear it
+         * @return false if the desktop or slot does not exist
+         */
+        bool setWorkspaceID(const int desktopID, const size_t slot, const WORKSPACEID id);
+
+        // Occupancy
+
+        /**
+         * @brief Mark whether the workspace in a cell holds windows
+         */
+        void setOccupied(const SCell& cell, const bool occupied);
+
+        /**
+         * @brief Desktops with windows on any slot, by index into getDesktops()
+         */
+        const CDesktopBitset& getOccupied() const { return m_occupied; }
+
+        /**
+         * @brief Desktops with windows on a slot, by index into getDesktops()
+         */
+        const CDesktopBitset& getOccupied(const size_t slot) const { return slot < m_slotOccupied.size() ? m_slotOccupied[slot] : m_occupied; }
+
+        // Monitor slots
+
+        /**
+         * @brief Attach a monitor to its slot, creating the slot on first sight
+         * @return Slot index
+         */
+        size_t attachMonitor(const MONITORID id, const std::string& name);
+
+        /**
+         * @brief Detach a monitor, keeping its slot for when it comes back
+         */
+        void detachMonitor(const MONITORID id);
+
+        /**
+         * @brief Slot of a connected monitor
+         * @return Slot index, nullopt if the monitor is not attached
+         */
+        std::optional<size_t> getSlot(const MONITORID id) const;
+
+        size_t getSlotCount() const { return m_slots.size(); }
+        MONITORID getSlotMonitor(const size_t slot) const { return slot < m_slots.size() ? m_slots[slot].monitorID : -1; }
+
     private:
+        struct SMonitorSlot {
+            std::string name;
+            MONITORID monitorID = -1;
+        };
+
+        WORKSPACEID& cell(const size_t desktop, const size_t slot) { return m_workspaces[desktop * m_stride + slot]; }
+        std::optional<size_t> indexOf(const int id) const;
+
+        /**
+         * @brief Widen the rows to hold at least @p slots slots
+         */
+        void reserveSlots(const size_t slots);
+
+        /**
+         * @brief Point every desktop at its row, after the matrix or slot count changed
+         */
+        void rebindRows();
+
         int m_vdeskCounter = 0;
+        int m_activeDesktopID = -1;
         std::vector<CVirtualDesktop> m_virtualDesktops;
+        std::vector<SMonitorSlot> m_slots;
+
+        // [desktop][slot] matrix, rows m_stride wide; slots past m_slots.size() are spare
+        std::vector<WORKSPACEID> m_workspaces;
+        size_t m_stride = 0;
+        std::unordered_map<WORKSPACEID, SCell> m_workspaceCells;
+
+        CDesktopBitset m_occupied;
+        std::vector<CDesktopBitset> m_slotOccupied;
 
     }; // class CLayout
 
-} // namespace VDM
\ No newline at end of file
+} // namespace VDM
@@ -1,13 +1,20 @@
 
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string_view>
 #include <utility>
 #include <optional>
+#include <atomic>
+#include <format>
+#include <iterator>
+#include <source_location>
+#include <string>
 #include <hyprutils/cli/Logger.hpp>
+#include "BinaryLog.hpp"
 namespace CLI = Hyprutils::CLI;
 
 #define APPLOG_USE_SCOPED_ENUM
-#include <hyprland/src/debug/log/Logger.hpp>
 
 namespace AppLog {
 
@@ -61,8 +68,44 @@ namespace AppLog {
 
     Logger& getLogger();
 
+    // ---- Asynchronous mode ----
+    // Records are decorated on the caller's thread into a fixed-size slot of a
+    // bounded lock-free ring; a background thread drains the ring in batches
+    // and does the actual writes. Messages longer than a slot are truncated.
+    enum class OverflowPolicy {
+        Drop,   // Discard the record and count it (see getDroppedCount)
+        Block   // Wait for the flusher to free a slot
+    };
+
+    struct AsyncOptions {
+        bool enabled = false;
+        size_t capacity = 1024;     // Records, rounded up to a power of two
+        OverflowPolicy overflow = OverflowPolicy::Drop;
+    };
+
     // ---- Initialization and configuration ----
-    void initLogging(bool toStdout = true, bool colored = true, const char* filePath = nullptr, const std::string_view& tag = "");
+    void initLogging(bool toStdout = true, bool colored = true, const char* filePath = nullptr, const std::string_view& tag = "",
+                     const AsyncOptions& async = {});
+
+    // Turn asynchronous mode on or off, or change its capacity or policy, e.g.
+    // after a config reload. Records queued so far are written first
+    void setAsyncOptions(const AsyncOptions& async);
+
+    // Wait until every record queued so far has been written. No-op in synchronous mode
+    void flushLogging();
+
+    // Flush, stop the flusher thread, close the binary log and go back to
+    // synchronous logging
+    void shutdownLogging();
+
+    // Records discarded by OverflowPolicy::Drop since logging was initialized
+    uint64_t getDroppedCount();
+
+    // Switch the formatted API (trace/info/warn/error, APPLOG_CTX) to binary
+    // records in a memory-mapped file; decode it with vdm-logdecode. The
+    // string-based calls keep going to the text sinks
+    bool openBinaryLog(const char* path);
+    void closeBinaryLog();
 
     // ---- Minimum level configuration ----
     void setMinLevel(LogLevel lvl);
@@ -94,16 +137,110 @@ namespace AppLog {
     inline void logError(const std::string_view& category, const std::string_view& msg, const std::string_view& tag = "") { logWithCategory(LogLevel::Error, category, msg, tag); }
 
 
-    // ---- Macro con contesto (opzionale: usa std::source_location) ----
-    // inline void logCtx(LogLevel lvl, std::string_view msg,
-    //                std::string_view tag = "",
-    //                const std::source_location& loc = std::source_location::current()) {
-    // if (lvl < getMinLevel()) return;
-    // const auto ctx = std::format("{}:{} {}", loc.file_name(), loc.line(), msg);
-    // getLogger().log(toUnderlying(lvl),
-    //                 ctx,
-    //                 tag.empty() ? std::nullopt : std::make_optional(tag));
-    // }
+    // ---- Compile-time threshold ----
+    // Calls below APPLOG_MIN_LEVEL (0 = Trace, 1 = Info, 2 = Warn, 3 = Error)
+    // are compiled out of the formatted API and APPLOG_CTX. Release builds
+    // (NDEBUG) drop trace and debug output unless the threshold is set.
+    #ifndef APPLOG_MIN_LEVEL
+        #ifdef NDEBUG
+            #define APPLOG_MIN_LEVEL 2
+        #else
+            #define APPLOG_MIN_LEVEL 0
+        #endif
+    #endif
+
+    constexpr LogLevel COMPILED_MIN_LEVEL = static_cast<LogLevel>(APPLOG_MIN_LEVEL);
+
+    constexpr bool isCompiledIn(LogLevel lvl) noexcept { return lvl >= COMPILED_MIN_LEVEL; }
+
+    // ---- Categories ----
+    // Each category can be switched on and off at runtime; all are on by default
+    enum class Category : uint8_t { General, Index, VDesk, Events, Count };
+
+    constexpr std::string_view categoryName(Category category) noexcept {
+        switch (category) {
+            case Category::General: return "";
+            case Category::Index:   return "index";
+            case Category::VDesk:   return "vdesk";
+            case Category::Events:  return "events";
+            case Category::Count:   break;
+        }
+        return "";
+    }
+
+    namespace detail {
+        extern std::atomic<uint32_t> gCategoryMask;
+
+        // Format into a per-thread buffer and hand it to the logger
+        std::string& formatBuffer();
+        void emit(LogLevel lvl, Category category);
+    }
+
+    void setCategoryEnabled(Category category, bool enabled);
+
+    inline bool isCategoryEnabled(Category category) {
+        return detail::gCategoryMask.load(std::memory_order_relaxed) & (1u << static_cast<uint32_t>(category));
+    }
+
+    inline bool isEnabled(LogLevel lvl, Category category) {
+        return lvl >= getMinLevel() && isCategoryEnabled(category);
+    }
+
+    // ---- Formatted API ----
+    // The arguments are only formatted once the compile-time threshold, the
+    // runtime level and the category have all let the call through, e.g.
+    //     AppLog::trace(AppLog::Category::VDesk, "Switched to desktop {}", id);
+    //
+    // In binary mode (see BinaryLog.hpp) nothing is formatted at all: the call
+    // site registers its format string once and writes the raw arguments.
+    // `CallSite` is a lambda type defaulted in trace/info/warn/error, so each
+    // call site gets its own instantiation and its own cached descriptor.
+    template <LogLevel LVL, typename CallSite, typename... Args>
+    inline void logFormat(Category category, std::format_string<Args...> fmt, Args&&... args) {
+        if constexpr (isCompiledIn(LVL)) {
+            if (!isEnabled(LVL, category))
+                return;
+
+            if (binary::isActive()) {
+                // Categories are runtime values, so a site that logs to several
+                // registers once per category it switches to
+                static std::atomic<binary::Site*> site{nullptr};
+                binary::Site* cached = site.load(std::memory_order_acquire);
+                if (!cached || cached->category != categoryName(category)) {
+                    constexpr const auto& types = binary::detail::ARG_TYPES<std::remove_cvref_t<Args>...>;
+                    cached = binary::registerSite(static_cast<uint8_t>(LVL), categoryName(category), fmt.get(),
+                                                  types.data(), static_cast<uint8_t>(types.size()));
+                    site.store(cached, std::memory_order_release);
+                }
+                binary::write(*cached, args...);
+                return;
+            }
+
+            auto& buffer = detail::formatBuffer();
+            buffer.clear();
+            std::format_to(std::back_inserter(buffer), fmt, std::forward<Args>(args)...);
+            detail::emit(LVL, category);
+        }
+    }
+
+    template <typename... Args, typename CallSite = decltype([] {})>
+    inline void trace(Category category, std::format_string<Args...> fmt, Args&&... args) { logFormat<LogLevel::Trace, CallSite>(category, fmt, std::forward<Args>(args)...); }
+    template <typename... Args, typename CallSite = decltype([] {})>
+    inline void info(Category category, std::format_string<Args...> fmt, Args&&... args) { logFormat<LogLevel::Info, CallSite>(category, fmt, std::forward<Args>(args)...); }
+    template <typename... Args, typename CallSite = decltype([] {})>
+    inline void warn(Category category, std::format_string<Args...> fmt, Args&&... args) { logFormat<LogLevel::Warn, CallSite>(category, fmt, std::forward<Args>(args)...); }
+    template <typename... Args, typename CallSite = decltype([] {})>
+    inline void error(Category category, std::format_string<Args...> fmt, Args&&... args) { logFormat<LogLevel::Error, CallSite>(category, fmt, std::forward<Args>(args)...); }
+
+    // Prefixes the message with "file:line function: "
+    template <LogLevel LVL, typename... Args>
+    inline void logFormatCtx(Category category, const std::source_location& loc, std::format_string<Args...> fmt, Args&&... args) {
+        auto& buffer = detail::formatBuffer();
+        buffer.clear();
+        std::format_to(std::back_inserter(buffer), "{}:{} {}: ", loc.file_name(), loc.line(), loc.function_name());
+        std::format_to(std::back_inserter(buffer), fmt, std::forward<Args>(args)...);
+        detail::emit(LVL, category);
+    }
 
 } // Namespace AppLog
 
@@ -115,11 +252,14 @@ namespace AppLog {
         std::string_view{MSG} \
     )
 
-// More detailed - file/line/function in the message
-#define APPLOG_CTX(LVL, MSG) \
-    AppLog::getLogger().log( \
-        AppLog::toUnderlying(LVL), \
-        std::string_view{ \
-            MSG \
+// More detailed - file/line/function in the message. The source location is
+// only captured when the call passes the level and category checks, and the
+// whole call disappears below APPLOG_MIN_LEVEL:
+//     APPLOG_CTX(AppLog::LogLevel::Trace, AppLog::Category::Index, "rebuilt {} workspaces", n);
+#define APPLOG_CTX(LVL, CATEGORY, ...) \
+    do { \
+        if constexpr (AppLog::isCompiledIn(LVL)) { \
+            if (AppLog::isEnabled(LVL, CATEGORY)) \
+                AppLog::logFormatCtx<LVL>(CATEGORY, std::source_location::current(), __VA_ARGS__); \
         } \
-    )
+    } while (0)
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CompositorBackend.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace VDM {
+
+/**
+ * @brief In-memory compositor used to run the VDM core without Hyprland
+ *
+ * Simulates monitors, workspaces and windows with Hyprland-like semantics:
+ * every monitor always shows a workspace, workspaces belong to exactly one
+ * monitor and windows live on exactly one workspace. Mutations emit the same
+ * listener events the Hyprland backend does, synchronously.
+ */
+class CMockBackend : public ICompositorBackend {
+public:
+    CMockBackend();
+    ~CMockBackend() override;
+
+    // Simulation controls
+
+    /**
+     * @brief Plug in a monitor, creating a workspace for it to show
+     * @return ID of the new monitor
+     */
+    MONITORID addMonitor(const std::string& name, int32_t width = 1920, int32_t height = 1080);
+
+    /**
+     * @brief Unplug a monitor, moving its workspaces to the first remaining one
+     */
+    void removeMonitor(MONITORID id);
+
+    /**
+     * @brief Destroy a workspace and every window on it
+     */
+    void destroyWorkspace(WORKSPACEID id);
+
+    void setFocusedMonitor(MONITORID id);
+
+    WINDOWID openWindow(WORKSPACEID workspaceID);
+    void closeWindow(WINDOWID id);
+    void moveWindow(WINDOWID id, WORKSPACEID workspaceID);
+    void setFullscreen(WINDOWID id, bool fullscreen);
+    void setUrgent(WINDOWID id, bool urgent);
+
+    size_t getWindowCount() const { return m_windows.size(); }
+
+    /**
+     * @brief Number of notifications posted through notify()
+     */
+    size_t getNotificationCount() const { return m_notificationCount; }
+
+    // ICompositorBackend
+
+    std::vector<SMonitorState> getMonitors() override;
+    std::vector<SWorkspaceState> getWorkspaces() override;
+    std::optional<SMonitorState> getMonitor(MONITORID id) override;
+    std::optional<SWorkspaceState> getWorkspace(WORKSPACEID id) override;
+    void forEachMonitor(CFunctionRef<void(const SMonitorView&)> fn) override;
+    void forEachWorkspace(CFunctionRef<void(const SWorkspaceView&)> fn) override;
+    std::optional<SMonitorView> getMonitorView(MONITORID id) override;
+    std::optional<SWorkspaceView> getWorkspaceView(WORKSPACEID id) override;
+    std::vector<SWindowState> getWindows() override;
+    MONITORID getMonitorIDByName(std::string_view name) override;
+    MONITORID getFocusedMonitorID() override;
+    WORKSPACEID getActiveWorkspaceID(MONITORID monitorID) override;
+    std::string getCurrentLayout() override;
+
+    bool createWorkspace(WORKSPACEID id, MONITORID monitorID, const std::string& name) override;
+    bool changeWorkspace(MONITORID monitorID, WORKSPACEID id) override;
+    bool changeWorkspaces(std::span<const SWorkspaceAssignment> assignments, bool animate) override;
+    bool moveWorkspaceToMonitor(WORKSPACEID id, MONITORID monitorID) override;
+    bool renameWorkspace(WORKSPACEID id, const std::string& name) override;
+    void releaseWorkspaces(std::span<const WORKSPACEID> ids) override;
+
+    void notify(const std::string& message, eNotifyLevel level, int durationMs) override;
+
+private:
+    struct SMockWindow {
+        WORKSPACEID workspaceID = -1;
+        bool fullscreen = false;
+        bool urgent = false;
+    };
+
+    static SMonitorView toView(const SMonitorState& monitor);
+    static SWorkspaceView toView(const SWorkspaceState& workspace);
+
+    SMonitorState* findMonitor(MONITORID id);
+    SWorkspaceState* findWorkspace(WORKSPACEID id);
+    WORKSPACEID nextFreeWorkspaceID() const;
+
+    // Kept in insertion order, like the compositor lists
+    std::vector<SMonitorState> m_monitors;
+    std::vector<SWorkspaceState> m_workspaces;
+    std::unordered_map<WINDOWID, SMockWindow> m_windows;
+
+    MONITORID m_nextMonitorID = 0;
+    WINDOWID m_nextWindowID = 1;
+    MONITORID m_focusedMonitorID = -1;
+    size_t m_notificationCount = 0;
+};
+
+} // namespace VDM
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CompositorBackend.hpp"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace VDM {
+
+    /**
+     * @brief Resolves user-supplied monitor selectors to monitor IDs
+     *
+     * Understood selectors, tried in this order:
+     *  - monitor name, e.g. "DP-1"
+     *  - numeric monitor ID, e.g. "0"
+     *  - "desc:" followed by a substring of the monitor description
+     *
+     * Names are looked up in a hash table keyed by views of the interned
+     * names, rebuilt whenever a monitor is added or removed, so resolving a
+     * selector never allocates or throws. "current" is left to the caller,
+     * which knows the focused monitor.
+     */
+    class CMonitorResolver {
+    public:
+        static constexpr std::string_view DESCRIPTION_PREFIX = "desc:";
+        static constexpr std::string_view CURRENT = "current";
+
+        /**
+         * @brief Resolve a selector
+         * @return Monitor ID, -1 if no monitor matches
+         */
+        MONITORID resolve(std::string_view selector) const;
+
+        void addMonitor(const SMonitorState& monitor);
+        void removeMonitor(const MONITORID id);
+
+        /**
+         * @brief Forget every monitor
+         */
+        void clear();
+
+    private:
+        struct SMonitorEntry {
+            MONITORID id = -1;
+            std::string name;
+            std::string description;
+        };
+
+        void rebuildNameTable();
+
+        // Owns the interned names; m_byName holds views into it
+        std::vector<SMonitorEntry> m_monitors;
+        std::unordered_map<std::string_view, MONITORID> m_byName;
+
+    }; // class CMonitorResolver
+
+} // namespace VDM
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "CompositorBackend.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace VDM {
+
+/**
+ * @brief Which notifications reach the compositor
+ */
+enum eNotifyVerbosity : uint8_t {
+    NOTIFY_VERBOSITY_OFF = 0,
+    NOTIFY_VERBOSITY_ERRORS,
+    NOTIFY_VERBOSITY_WARNINGS,
+    NOTIFY_VERBOSITY_ALL
+};
+
+/**
+ * @brief Kind of notification, the unit bursts are merged by
+ *
+ * `summary` is shown instead of the individual messages when a burst is
+ * merged; "{}" is replaced with the number of notifications in the burst.
+ */
+struct SNotifyTopic {
+    std::string_view key;
+    std::string_view summary;
+    int durationMs = 3000;
+};
+
+namespace NotifyTopics {
+    inline constexpr SNotifyTopic WORKSPACE_CREATED{"workspace.created", "[VDM] Created {} workspaces"};
+    inline constexpr SNotifyTopic WORKSPACE_DELETED{"workspace.deleted", "[VDM] Deleted {} workspaces"};
+    inline constexpr SNotifyTopic WORKSPACE_MOVED{"workspace.moved", "[VDM] Moved {} workspaces"};
+    inline constexpr SNotifyTopic WORKSPACE_RENAMED{"workspace.renamed", "[VDM] Renamed {} workspaces"};
+    inline constexpr SNotifyTopic WORKSPACE_REJECTED{"workspace.rejected", "[VDM] {} workspace operations rejected"};
+    inline constexpr SNotifyTopic WORKSPACE_FAILED{"workspace.failed", "[VDM] {} workspace operations failed"};
+    inline constexpr SNotifyTopic DESKTOP_FAILED{"desktop.failed", "[VDM] {} desktop switches failed"};
+    inline constexpr SNotifyTopic COMMAND_FAILED{"command.failed", "[VDM] Failed to register {} commands", 5000};
+    inline constexpr SNotifyTopic PLUGIN_STATUS{"plugin.status", "[VDM] {} plugin status changes", 2000};
+}
+
+/**
+ * @brief Rate limiter in front of ICompositorBackend::notify()
+ *
+ * Every notification is a rendered texture, so scripted bulk operations
+ * (20 desktops x 3 monitors at login) must not raise one each. The first
+ * notification of a topic is shown right away and opens a time window; the
+ * ones that follow within the window are only counted, and when the window
+ * ends a single summary ("[VDM] Created 60 workspaces") replaces them.
+ *
+ * Messages are only formatted when they are actually shown: filtered and
+ * merged notifications cost a level check and a map lookup.
+ */
+class CNotificationScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds DEFAULT_WINDOW{750};
+
+    explicit CNotificationScheduler(ICompositorBackend* backend = nullptr) : m_pBackend(backend) {}
+
+    /**
+     * @brief Backend notifications are posted to; pending bursts are dropped
+     */
+    void setBackend(ICompositorBackend* backend);
+
+    void setVerbosity(eNotifyVerbosity verbosity) { m_verbosity = verbosity; }
+    eNotifyVerbosity getVerbosity() const { return m_verbosity; }
+
+    /**
+     * @brief Length of the window bursts are merged over
+     */
+    void setWindow(std::chrono::milliseconds window) { m_window = window; }
+
+    /**
+     * @brief Hook to schedule a call to dispatch()
+     *
+     * Called with the delay in milliseconds when a burst has a summary
+     * pending, so the host can run dispatch() from its event loop. Without a
+     * timer, summaries are posted when the topic is used again after the
+     * window or on flush().
+     */
+    void setTimerCallback(std::function<void(int)> callback) { m_timerCallback = std::move(callback); }
+
+    /**
+     * @brief Check whether notifications of a level pass the verbosity
+     */
+    bool isEnabled(eNotifyLevel level) const;
+
+    /**
+     * @brief Post a notification, or count it into the topic's current burst
+     */
+    template <typename... Args>
+    void post(const SNotifyTopic& topic, eNotifyLevel level, std::format_string<Args...> fmt, Args&&... args) {
+        if (!m_pBackend || !isEnabled(level) || !admit(topic, level))
+            return;
+        m_pBackend->notify(std::format(fmt, std::forward<Args>(args)...), level, topic.durationMs);
+    }
+
+    /**
+     * @brief Post the summaries of the bursts whose window has ended
+     */
+    void dispatch();
+
+    /**
+     * @brief Post every pending summary now
+     */
+    void flush();
+
+    /**
+     * @brief Notifications merged into summaries so far
+     */
+    uint64_t getMergedCount() const { return m_mergedCount; }
+
+private:
+    struct SBurst {
+        const SNotifyTopic* topic = nullptr;
+        Clock::time_point windowEnd;
+        eNotifyLevel level = NOTIFY_OK;
+        uint32_t merged = 0;
+    };
+
+    /**
+     * @brief Record a notification of a topic
+     * @return true if it has to be shown now, false if it was merged
+     */
+    bool admit(const SNotifyTopic& topic, eNotifyLevel level);
+
+    void postSummary(const SBurst& burst);
+    void armTimer(Clock::time_point now);
+
+    ICompositorBackend* m_pBackend = nullptr;
+    eNotifyVerbosity m_verbosity = NOTIFY_VERBOSITY_ALL;
+    std::chrono::milliseconds m_window = DEFAULT_WINDOW;
+    std::function<void(int)> m_timerCallback;
+
+    // Open bursts by topic key; keys are string literals
+    std::unordered_map<std::string_view, SBurst> m_bursts;
+    uint64_t m_mergedCount = 0;
+};
+
+} // namespace VDM
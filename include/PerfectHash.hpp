@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace VDM {
+
+/**
+ * @brief Lookup table with a perfect hash over a fixed set of names
+ *
+ * Built at compile time from an array of entries that have a `name` member:
+ * the constructor searches for a hash seed under which no two names share a
+ * slot, so a lookup is one hash, one slot and one string compare. A set of
+ * names without such a seed fails to compile.
+ *
+ *   constexpr SEntry ENTRIES[] = {{"list", ...}, {"info", ...}};
+ *   constexpr CPerfectHashTable TABLE{ENTRIES};
+ *   const SEntry* entry = TABLE.find("list");
+ */
+template <typename Entry, size_t N>
+class CPerfectHashTable {
+public:
+    // At most half full, so a seed is found within a few tries
+    static constexpr size_t SLOTS = std::bit_ceil(N * 2);
+
+    consteval explicit CPerfectHashTable(const Entry (&entries)[N]) {
+        for (uint32_t seed = 1; seed < MAX_SEED; ++seed) {
+            if (build(entries, seed))
+                return;
+        }
+        throw "CPerfectHashTable: no collision-free seed for these names";
+    }
+
+    constexpr const Entry* find(std::string_view name) const {
+        const SSlot& slot = m_slots[hash(name, m_seed) & (SLOTS - 1)];
+        return slot.used && slot.entry.name == name ? &slot.entry : nullptr;
+    }
+
+private:
+    static constexpr uint32_t MAX_SEED = 1 << 16;
+
+    struct SSlot {
+        Entry entry{};
+        bool used = false;
+    };
+
+    // FNV-1a, with the seed mixed into the offset basis
+    static constexpr uint32_t hash(std::string_view name, uint32_t seed) {
+        uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+        for (const char c : name) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 16777619u;
+        }
+        return h ^ (h >> 16);
+    }
+
+    constexpr bool build(const Entry (&entries)[N], uint32_t seed) {
+        m_slots = {};
+        for (const Entry& entry : entries) {
+            SSlot& slot = m_slots[hash(entry.name, seed) & (SLOTS - 1)];
+            if (slot.used)
+                return false;
+            slot = {.entry = entry, .used = true};
+        }
+        m_seed = seed;
+        return true;
+    }
+
+    std::array<SSlot, SLOTS> m_slots{};
+    uint32_t m_seed = 0;
+};
+
+} // namespace VDM
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace VDM {
+
+/**
+ * @brief Per-request memory arena for hyprctl command handlers
+ *
+ * Scratch data a handler builds while serializing (strings, vectors, nested
+ * JSON) comes from a monotonic arena instead of the global heap, and the
+ * whole arena is dropped in one go once the reply has been returned. Only
+ * the reply itself, which Hyprland takes as a std::string, hits the heap,
+ * so polling bars do not fragment the compositor's heap over long uptimes.
+ *
+ * The first INLINE_SIZE bytes live in a per-thread buffer; larger requests
+ * grow into blocks that are pooled and reused by the next request.
+ */
+class CRequestArena {
+public:
+    static constexpr size_t INLINE_SIZE = 16 * 1024;
+
+    /**
+     * @brief Marks a request: the arena is reset when the outermost scope ends
+     */
+    class CScope {
+    public:
+        CScope();
+        ~CScope();
+
+        CScope(const CScope&) = delete;
+        CScope& operator=(const CScope&) = delete;
+    };
+
+    /**
+     * @brief Resource for per-request allocations
+     *
+     * The arena while a CScope is active on this thread, the default
+     * resource otherwise, so helpers called outside a request (benchmarks,
+     * the mock backend) never grow an arena nobody resets.
+     */
+    static std::pmr::memory_resource* getResource();
+};
+
+} // namespace VDM
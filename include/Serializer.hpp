@@ -0,0 +1,337 @@
+#pragma once
+
+#include "VdmTypes.hpp"
+#include "VirtualDesktop.hpp"
+#include "workspace_manager.hpp"
+
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace VDM {
+
+/**
+ * @brief Streaming serializer for hyprctl replies and event payloads
+ *
+ * Appends straight into a caller-owned buffer (std::string, std::pmr::string
+ * or anything with append/push_back), so a buffer kept across calls is
+ * reused without reallocating. Each type is described once, as a sequence
+ * of beginObject/field/endObject calls (see the serialize() overloads
+ * below), and rendered as JSON or as the plain text hyprctl shows by default:
+ *
+ *   JSON   {"generation": 42, "desktops": [{"id": 1, "name": "Web"}]}
+ *   plain  generation: 42
+ *          desktops:
+ *                  desktop 1:
+ *                          name: Web
+ *
+ * In plain text a labelled object gets a header line ("desktop"); fields
+ * written with keyField() are appended to that header instead of getting a
+ * line of their own. Numbers go through std::to_chars and strings are
+ * escaped in place: no temporaries, no locale, no streams.
+ */
+template <typename Buffer>
+class CSerializer {
+public:
+    CSerializer(Buffer& out, eHyprCtlOutputFormat format) : m_out(out), m_json(format == eHyprCtlOutputFormat::FORMAT_JSON) {}
+
+    bool isJson() const { return m_json; }
+
+    /**
+     * @brief Open an object: the root, an array element, or a member with `key`
+     * @param label Plain text header, e.g. "desktop"; empty for no header
+     */
+    void beginObject(std::string_view key = {}, std::string_view label = {}) {
+        if (m_json) {
+            openValue(key);
+            m_out.push_back('{');
+        } else if (!key.empty() || !label.empty()) {
+            indent();
+            append(label.empty() ? key : label);
+            m_headerOpen = true;
+        }
+        push(!key.empty() || !label.empty());
+    }
+
+    void endObject() {
+        closeHeader();
+        if (m_json)
+            m_out.push_back('}');
+        pop();
+    }
+
+    /**
+     * @brief Open an array member; elements are objects or values without a key
+     */
+    void beginArray(std::string_view key) {
+        closeHeader();
+        if (m_json) {
+            openValue(key);
+            m_out.push_back('[');
+        } else {
+            indent();
+            append(key);
+            append(":\n");
+        }
+        push(true);
+    }
+
+    void endArray() {
+        if (m_json)
+            m_out.push_back(']');
+        pop();
+    }
+
+    /**
+     * @brief Identifying field: part of the header line in plain text
+     */
+    template <typename T>
+    void keyField(std::string_view key, const T& value) {
+        if (!m_json && m_headerOpen) {
+            m_out.push_back(' ');
+            writeValue(value);
+            return;
+        }
+        field(key, value);
+    }
+
+    template <typename T>
+    void field(std::string_view key, const T& value) {
+        closeHeader();
+        if (m_json) {
+            openValue(key);
+            writeValue(value);
+            return;
+        }
+        indent();
+        append(key);
+        append(": ");
+        writeValue(value);
+        m_out.push_back('\n');
+    }
+
+    /**
+     * @brief Field holding a list of numbers: a JSON array, space-separated in plain text
+     */
+    template <typename T>
+    void field(std::string_view key, std::span<const T> values) {
+        closeHeader();
+        if (m_json) {
+            openValue(key);
+            m_out.push_back('[');
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (i)
+                    append(", ");
+                writeValue(values[i]);
+            }
+            m_out.push_back(']');
+            return;
+        }
+        indent();
+        append(key);
+        m_out.push_back(':');
+        for (const auto& value : values) {
+            m_out.push_back(' ');
+            writeValue(value);
+        }
+        m_out.push_back('\n');
+    }
+
+private:
+    struct SLevel {
+        bool indents = false;
+        uint32_t count = 0;
+    };
+
+    static constexpr size_t MAX_DEPTH = 8;
+
+    void append(std::string_view text) { m_out.append(text.data(), text.size()); }
+
+    void push(bool indents) {
+        if (m_depth < MAX_DEPTH)
+            m_levels[m_depth] = {.indents = indents, .count = 0};
+        ++m_depth;
+    }
+
+    void pop() {
+        if (m_depth > 0)
+            --m_depth;
+    }
+
+    // JSON: separator and key for the next value in the current container
+    void openValue(std::string_view key) {
+        if (m_depth > 0 && m_depth <= MAX_DEPTH && m_levels[m_depth - 1].count++ > 0)
+            append(", ");
+        if (!key.empty()) {
+            // Keys are identifiers from the type descriptions: nothing to escape
+            m_out.push_back('"');
+            append(key);
+            append("\": ");
+        }
+    }
+
+    void closeHeader() {
+        if (!m_headerOpen)
+            return;
+        append(":\n");
+        m_headerOpen = false;
+    }
+
+    void indent() {
+        for (size_t i = 0; i < std::min(m_depth, MAX_DEPTH); ++i) {
+            if (m_levels[i].indents)
+                m_out.push_back('\t');
+        }
+    }
+
+    template <typename T>
+    void writeValue(const T& value) {
+        if constexpr (std::same_as<T, bool>) {
+            append(value ? "true" : "false");
+        } else if constexpr (std::integral<T> || std::floating_point<T>) {
+            std::array<char, 32> buf;
+            const auto result = std::to_chars(buf.data(), buf.data() + buf.size(), value);
+            m_out.append(buf.data(), result.ptr - buf.data());
+        } else {
+            const std::string_view text{value};
+            if (m_json)
+                writeString(text);
+            else
+                append(text);
+        }
+    }
+
+    void writeString(std::string_view value) {
+        static constexpr char HEX[] = "0123456789abcdef";
+
+        m_out.push_back('"');
+        size_t run = 0;
+        for (size_t i = 0; i < value.size(); ++i) {
+            const char c = value[i];
+            if (c != '"' && c != '\\' && static_cast<unsigned char>(c) >= 0x20)
+                continue;
+
+            // Copy the clean run before the character in one go
+            append(value.substr(run, i - run));
+            run = i + 1;
+            switch (c) {
+                case '"':  append("\\\""); break;
+                case '\\': append("\\\\"); break;
+                case '\n': append("\\n"); break;
+                case '\r': append("\\r"); break;
+                case '\t': append("\\t"); break;
+                case '\b': append("\\b"); break;
+                case '\f': append("\\f"); break;
+                default:
+                    append("\\u00");
+                    m_out.push_back(HEX[(c >> 4) & 0xf]);
+                    m_out.push_back(HEX[c & 0xf]);
+            }
+        }
+        append(value.substr(run));
+        m_out.push_back('"');
+    }
+
+    Buffer& m_out;
+    bool m_json;
+    bool m_headerOpen = false;
+    std::array<SLevel, MAX_DEPTH> m_levels{};
+    size_t m_depth = 0;
+};
+
+template <typename Buffer>
+CSerializer(Buffer&, eHyprCtlOutputFormat) -> CSerializer<Buffer>;
+
+// Type descriptions, one per type for both output formats
+
+/**
+ * @brief Desktop fields, for listings that only ask for some of them
+ */
+enum eDesktopField : uint32_t {
+    DESKTOP_FIELD_ID         = 1 << 0,
+    DESKTOP_FIELD_NAME       = 1 << 1,
+    DESKTOP_FIELD_ACTIVE     = 1 << 2,
+    DESKTOP_FIELD_WORKSPACES = 1 << 3,
+    DESKTOP_FIELD_WINDOWS    = 1 << 4,
+    DESKTOP_FIELD_FULLSCREEN = 1 << 5,
+    DESKTOP_FIELD_URGENT     = 1 << 6,
+
+    // Belongs to the listing rather than to a desktop: the occupancy bitmask
+    DESKTOP_FIELD_OCCUPIED   = 1 << 7,
+
+    DESKTOP_FIELDS_COUNTERS = DESKTOP_FIELD_WINDOWS | DESKTOP_FIELD_FULLSCREEN | DESKTOP_FIELD_URGENT,
+    DESKTOP_FIELDS_DESKTOP  = (1 << 7) - 1,
+    DESKTOP_FIELDS_ALL      = DESKTOP_FIELDS_DESKTOP | DESKTOP_FIELD_OCCUPIED
+};
+
+/**
+ * @brief Desktop with a subset of its fields
+ * @param workspaces Workspaces to list, e.g. only the one on a given monitor
+ * @param counters Returns the window counters; only called if a counter field is requested
+ */
+template <typename Buffer, typename Counters>
+    requires std::invocable<Counters&>
+void serialize(CSerializer<Buffer>& out, const CVirtualDesktop& desktop, uint32_t fields,
+               std::span<const WORKSPACEID> workspaces, Counters&& counters) {
+    out.beginObject({}, "desktop");
+    if (fields & DESKTOP_FIELD_ID)
+        out.keyField("id", desktop.getID());
+    if (fields & DESKTOP_FIELD_NAME)
+        out.field("name", desktop.getName());
+    if (fields & DESKTOP_FIELD_ACTIVE)
+        out.field("active", desktop.isActive());
+    if (fields & DESKTOP_FIELD_WORKSPACES)
+        out.field("workspaces", workspaces);
+    if (fields & DESKTOP_FIELDS_COUNTERS) {
+        const SWindowCounters values = counters();
+        if (fields & DESKTOP_FIELD_WINDOWS)
+            out.field("windows", values.windows);
+        if (fields & DESKTOP_FIELD_FULLSCREEN)
+            out.field("fullscreen", values.fullscreen);
+        if (fields & DESKTOP_FIELD_URGENT)
+            out.field("urgent", values.urgent);
+    }
+    out.endObject();
+}
+
+template <typename Buffer>
+void serialize(CSerializer<Buffer>& out, const CVirtualDesktop& desktop, const SWindowCounters& counters) {
+    serialize(out, desktop, DESKTOP_FIELDS_DESKTOP, std::span<const WORKSPACEID>(desktop.getWorkspaceIDs()),
+              [&] { return counters; });
+}
+
+template <typename Buffer>
+void serialize(CSerializer<Buffer>& out, const SWorkspaceInfoView& workspace) {
+    out.beginObject({}, "workspace");
+    out.keyField("id", workspace.id);
+    out.field("name", workspace.name);
+    out.field("monitor", workspace.monitorName);
+    out.field("monitorID", workspace.monitorID);
+    out.field("active", workspace.isActive);
+    out.field("windows", workspace.windows.windows);
+    out.field("fullscreen", workspace.windows.fullscreen);
+    out.field("urgent", workspace.windows.urgent);
+    out.endObject();
+}
+
+template <typename Buffer>
+void serialize(CSerializer<Buffer>& out, const SMonitorInfoView& monitor) {
+    out.beginObject({}, "monitor");
+    out.keyField("id", monitor.id);
+    out.field("name", monitor.name);
+    out.field("description", monitor.description);
+    out.field("width", monitor.width);
+    out.field("height", monitor.height);
+    out.field("refreshRate", monitor.refreshRate);
+    out.field("x", monitor.x);
+    out.field("y", monitor.y);
+    out.field("activeWorkspace", monitor.activeWorkspaceID);
+    out.field("activeWorkspaceName", monitor.activeWorkspaceName);
+    out.field("workspaces", monitor.workspaces);
+    out.endObject();
+}
+
+} // namespace VDM
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Trace.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Latency and allocation statistics for the plugin's entry points
+//
+// Every dispatcher, hyprctl handler, compositor event callback and workspace
+// manager operation records its duration into a per-operation log-linear
+// histogram (8 sub-buckets per power of two, so percentiles are within
+// ~12%). Counters are relaxed atomics: recording is a clock read, a few
+// fetch_adds and no locks. `hyprctl vdm stats` reports them. While tracing
+// is on (Trace.hpp) each scope is also recorded as a trace event.
+namespace VDM {
+
+/**
+ * @brief Instrumented operations
+ */
+enum eStatOp : uint8_t {
+    STAT_DISPATCH_VDESK = 0,
+
+    STAT_COMMAND_INFO,
+    STAT_COMMAND_LIST,
+    STAT_COMMAND_STATS,
+    STAT_COMMAND_TRACE,
+
+    STAT_EVENT_MONITOR_ADDED,
+    STAT_EVENT_MONITOR_REMOVED,
+    STAT_EVENT_WORKSPACE_CREATED,
+    STAT_EVENT_WORKSPACE_DESTROYED,
+    STAT_EVENT_WORKSPACE_MOVED,
+    STAT_EVENT_WORKSPACE_ACTIVATED,
+    STAT_EVENT_WINDOW_OPENED,
+    STAT_EVENT_WINDOW_CLOSED,
+    STAT_EVENT_WINDOW_MOVED,
+    STAT_EVENT_WINDOW_FULLSCREEN,
+    STAT_EVENT_WINDOW_URGENT,
+    STAT_EVENT_WINDOW_ACTIVATED,
+
+    STAT_WORKSPACE_CREATE,
+    STAT_WORKSPACE_DELETE,
+    STAT_WORKSPACE_SWITCH,
+    STAT_WORKSPACE_MOVE,
+    STAT_WORKSPACE_RENAME,
+    STAT_WORKSPACE_RECLAIM,
+    STAT_QUERY_WORKSPACES,
+    STAT_QUERY_MONITORS,
+
+    STAT_DESKTOP_SWITCH,
+
+    STAT_COUNT
+};
+
+/**
+ * @brief Summary of one operation's histogram, latencies in nanoseconds
+ *
+ * Percentiles are the upper bound of the bucket they fall in.
+ */
+struct SStatSummary {
+    std::string_view name;
+    uint64_t count = 0;
+    uint64_t meanNs = 0;
+    uint64_t p50Ns = 0;
+    uint64_t p90Ns = 0;
+    uint64_t p99Ns = 0;
+    uint64_t maxNs = 0;
+    uint64_t allocs = 0;
+};
+
+namespace Stats {
+
+    /**
+     * @brief Source of a monotonic allocation count, nullptr for none
+     *
+     * Installed by hosts that count allocations (vdm-bench, or the plugin
+     * built with VDM_STATS_ALLOCS); without one, allocation counts stay 0.
+     */
+    using AllocationCounter = uint64_t (*)();
+    void setAllocationCounter(AllocationCounter counter);
+    bool isCountingAllocations();
+    uint64_t getAllocationCount();
+
+    std::string_view getName(eStatOp op);
+
+    void record(eStatOp op, std::chrono::nanoseconds duration, uint64_t allocs);
+
+    SStatSummary getSummary(eStatOp op);
+
+    /**
+     * @brief Clear every histogram and counter
+     */
+    void reset();
+
+} // namespace Stats
+
+/**
+ * @brief Records the lifetime of a scope as one call of an operation
+ */
+class CStatScope {
+public:
+    explicit CStatScope(eStatOp op)
+        : m_op(op), m_allocs(Stats::getAllocationCount()), m_start(std::chrono::steady_clock::now()) {}
+
+    ~CStatScope() {
+        const auto end = std::chrono::steady_clock::now();
+        Stats::record(m_op, end - m_start, Stats::getAllocationCount() - m_allocs);
+        // Reuse the clock reads for the trace
+        if (Trace::isEnabled())
+            Trace::record(Stats::getName(m_op), m_start, end);
+    }
+
+    CStatScope(const CStatScope&) = delete;
+    CStatScope& operator=(const CStatScope&) = delete;
+
+private:
+    eStatOp m_op;
+    uint64_t m_allocs;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace VDM
+
+#define VDM_STAT_CONCAT_(a, b) a##b
+#define VDM_STAT_CONCAT(a, b) VDM_STAT_CONCAT_(a, b)
+
+// Time the rest of the enclosing scope as one call of OP
+#define VDM_STAT_SCOPE(OP) ::VDM::CStatScope VDM_STAT_CONCAT(vdmStatScope, __LINE__)(OP)
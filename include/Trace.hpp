@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Opt-in tracing of plugin activity, exported as Chrome trace-event JSON
+//
+// While tracing is on, every scope (VDM_TRACE_SCOPE, and every VDM_STAT_SCOPE
+// from Stats.hpp) is recorded as a complete event into a ring buffer owned by
+// the calling thread; when a buffer is full the oldest events are overwritten.
+// While it is off a scope costs one relaxed load. `hyprctl vdm trace` starts
+// and stops it; the dump loads in Perfetto (ui.perfetto.dev) or
+// chrome://tracing.
+namespace VDM::Trace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Events kept per thread
+    inline constexpr size_t BUFFER_EVENTS = 32768;
+
+    inline std::atomic<bool> gEnabled{false};
+
+    inline bool isEnabled() {
+        return gEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Drop the events recorded so far and start recording
+     */
+    void start();
+
+    /**
+     * @brief Stop recording; the events stay available to write()
+     */
+    void stop();
+
+    /**
+     * @brief Record a scope
+     * @param name Must outlive the trace, e.g. a string literal
+     */
+    void record(std::string_view name, Clock::time_point begin, Clock::time_point end);
+
+    /**
+     * @brief Write the recorded events as Chrome trace-event JSON
+     *
+     * The JSON is built in the request arena (see CRequestArena) when called
+     * from a command handler.
+     * @param events Set to the number of events written
+     * @return false if the file could not be written
+     */
+    bool write(std::string_view path, size_t& events);
+
+} // namespace VDM::Trace
+
+namespace VDM {
+
+/**
+ * @brief Records the lifetime of a scope as a trace event
+ */
+class CTraceScope {
+public:
+    explicit CTraceScope(std::string_view name) : m_name(name) {
+        if (Trace::isEnabled())
+            m_begin = Trace::Clock::now();
+    }
+
+    ~CTraceScope() {
+        if (m_begin != Trace::Clock::time_point{})
+            Trace::record(m_name, m_begin, Trace::Clock::now());
+    }
+
+    CTraceScope(const CTraceScope&) = delete;
+    CTraceScope& operator=(const CTraceScope&) = delete;
+
+private:
+    std::string_view m_name;
+    Trace::Clock::time_point m_begin{};
+};
+
+} // namespace VDM
+
+#define VDM_TRACE_CONCAT_(a, b) a##b
+#define VDM_TRACE_CONCAT(a, b) VDM_TRACE_CONCAT_(a, b)
+
+// Trace the rest of the enclosing scope as NAME
+#define VDM_TRACE_SCOPE(NAME) ::VDM::CTraceScope VDM_TRACE_CONCAT(vdmTraceScope, __LINE__)(NAME)
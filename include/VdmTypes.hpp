@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+// Types shared with Hyprland. The plugin build takes them from Hyprland's own
+// headers; the headless core (vdm-core without Hyprland) mirrors them here so
+// the same sources compile and run on a plain Linux box.
+#ifdef VDM_WITH_HYPRLAND
+#include <hyprland/src/SharedDefs.hpp>
+#else
+typedef int64_t WORKSPACEID;
+typedef int64_t MONITORID;
+typedef void*   HANDLE;
+
+enum eHyprCtlOutputFormat : uint8_t {
+    FORMAT_NORMAL = 0,
+    FORMAT_JSON
+};
+#endif
@@ -1,10 +1,10 @@
 #pragma once
 
-#include <hyprland/src/desktop/Workspace.hpp>
+#include "VdmTypes.hpp"
 
 #include <string>
-#include <vector>
 #include <optional>
+#include <span>
 #include <string_view>
 
 namespace VDM {
@@ -16,12 +16,17 @@ namespace VDM {
         ~CVirtualDesktop();
 
         // Getters
-        const std::string_view& getName() const { return m_name; }
+        std::string_view getName() const { return m_name; }
         const int getID() const { return m_id; }
 
         // Setters
         void setName(const std::string_view name) { m_name = name; }
 
+        // Workspaces, one per monitor slot, -1 if not assigned yet. A view of
+        // the desktop's row in the owning CLayout, which also assigns them
+        std::span<const WORKSPACEID> getWorkspaceIDs() const { return m_workspaceIds; }
+        WORKSPACEID getWorkspaceID(const size_t slot) const { return slot < m_workspaceIds.size() ? m_workspaceIds[slot] : -1; }
+
         // State
         void setActive(const bool active) { m_isActive = active; }
         const bool isActive() const { return m_isActive; }
@@ -30,9 +35,11 @@ namespace VDM {
         const std::string toStringDetailed() const;
 
     private:
+        friend class CLayout;
+
         int m_id;
-        std::string_view m_name;
-        std::vector<WORKSPACEID> m_workspaceIds;
+        std::string m_name;
+        std::span<const WORKSPACEID> m_workspaceIds;
         bool m_isActive = false;
 
     }; // class CVirtualDesktop
@@ -1,11 +1,208 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "CompositorBackend.hpp"
+#include "EventServer.hpp"
+#include "Layout.hpp"
+#include "WorkspaceReclaimer.hpp"
+#include "workspace_manager.hpp"
+
 namespace VDM {
 
-    class CVirtualDesktopManager {
+    /**
+     * @brief Outcome of a desktop switch
+     */
+    struct SSwitchResult {
+        bool success = false;
+        size_t monitorsChanged = 0;
+        std::chrono::nanoseconds duration{0};
+    };
+
+    /**
+     * @brief Owns the virtual desktop layout and switches between desktops
+     *
+     * A desktop switch changes the workspace of every monitor at once through
+     * ICompositorBackend::changeWorkspaces, so the compositor relayouts and
+     * announces the new state once instead of once per monitor.
+     *
+     * Desktops only reserve workspace IDs. A workspace is created the first
+     * time its desktop is shown on its monitor. When the desktop is left, its
+     * workspaces are handed to a CWorkspaceReclaimer, which releases the ones
+     * still empty and hidden after a grace period. The number of live
+     * workspaces follows use rather than the desktop count, and flipping
+     * between two desktops does not re-create workspaces on every switch.
+     *
+     * Switches requested through requestSwitch() are made at most once per
+     * frame interval. Requests that arrive while a switch is pending replace
+     * its target, so holding a key or hammering desktop keys shows the last
+     * requested desktop one frame later instead of queueing a relayout and
+     * animation per intermediate desktop.
+     */
+    class CVirtualDesktopManager : public IBackendListener {
     public:
+        /**
+         * @brief Size of the workspace ID range reserved for each desktop
+         *
+         * Desktop N prefers IDs (N-1)*WORKSPACES_PER_DESKTOP+1 onwards, one per
+         * monitor slot, so 1-3 is desktop 1 on three monitors, 11-13 desktop 2
+         * and so on. IDs outside the range are used once the range is taken.
+         */
+        static constexpr WORKSPACEID WORKSPACES_PER_DESKTOP = 10;
+
+        // Highest desktop ID: desktops up to the requested one are created on
+        // demand, so an unbounded ID would create desktops without end
+        static constexpr int MAX_DESKTOPS = 100;
+
+        // Minimum time between two coalesced switches, about a frame at 60 Hz
+        static constexpr std::chrono::milliseconds DEFAULT_FRAME_INTERVAL{16};
+
         static CVirtualDesktopManager& getInstance();
 
+        /**
+         * @brief Attach to a backend and adopt the workspaces on screen as desktop 1
+         * @param backend Backend to operate on, must outlive the manager
+         */
+        void initialize(ICompositorBackend* backend);
+
+        /**
+         * @brief Detach from the backend and drop all desktops
+         */
+        void shutdown();
+
+        /**
+         * @brief Show a desktop on all monitors
+         *
+         * Desktops up to @p id are created on demand, and their reserved
+         * workspaces are created when first shown. All monitors are switched
+         * in a single transaction; afterwards the previous desktop's
+         * workspaces are scheduled for release.
+         * @param id Desktop ID, 1 to MAX_DESKTOPS
+         * @param animate false to switch without the workspace animation
+         */
+        SSwitchResult switchToDesktop(const int id, const bool animate = true);
+
+        /**
+         * @brief Switch to a desktop, coalescing requests that come faster than a frame
+         *
+         * The switch is made right away unless the last one was less than a
+         * frame interval ago. Then it is deferred until the interval is over,
+         * and later requests replace its target. Without a timer callback
+         * every request switches right away.
+         * @param id Desktop ID, 1 to MAX_DESKTOPS
+         * @return false if @p id is out of range, or the switch was made right away and failed
+         */
+        bool requestSwitch(const int id);
+
+        /**
+         * @brief Make the pending switch, if any
+         */
+        void flushSwitch();
+
+        /**
+         * @brief Hook to schedule a call to flushSwitch()
+         *
+         * Called with the delay in milliseconds when a switch is deferred, so
+         * the host can run flushSwitch() from its event loop.
+         */
+        void setSwitchTimerCallback(std::function<void(int)> callback) { m_switchTimerCallback = std::move(callback); }
+
+        void setFrameInterval(std::chrono::milliseconds interval) { m_frameInterval = interval; }
+
+        /**
+         * @brief Switch without animation when requests come faster than this, 0 to always animate
+         */
+        void setInstantThreshold(std::chrono::milliseconds threshold) { m_instantThreshold = threshold; }
+
+        /**
+         * @brief Desktop that is shown once the pending switch is made
+         */
+        int getTargetDesktopID() const { return m_pendingSwitch != -1 ? m_pendingSwitch : m_layout.getActiveDesktopID(); }
+
+        uint64_t getSwitchRequestCount() const { return m_switchRequestCount; }
+
+        /**
+         * @brief Requested switches that were skipped because a later request replaced them
+         */
+        uint64_t getCoalescedCount() const { return m_coalescedCount; }
+
+        /**
+         * @brief Switches made without animation because requests came too fast
+         */
+        uint64_t getInstantSwitchCount() const { return m_instantSwitchCount; }
+
+        /**
+         * @brief Result of the last switchToDesktop() call
+         */
+        const SSwitchResult& getLastSwitch() const { return m_lastSwitch; }
+
+        /**
+         * @brief Next or previous desktop with windows, wrapping around
+         *
+         * Reads the layout's occupancy bitset; @p from itself is only
+         * returned if it is the only occupied desktop.
+         * @param from Desktop ID to start from
+         * @param forward true for the next desktop, false for the previous one
+         * @return Desktop ID, nullopt if no desktop has windows
+         */
+        std::optional<int> findOccupiedDesktop(const int from, const bool forward) const;
+
+        /**
+         * @brief Window, fullscreen and urgent counters summed over a desktop's workspaces
+         *
+         * One counter lookup per monitor slot, no window list walk.
+         * @param id Desktop ID
+         */
+        SWindowCounters getWindowCounters(const int id);
+
+        /**
+         * @brief State generation, bumped on every change that can alter a desktop listing
+         *
+         * Starts at 1 and only ever increases, also across initialize() and
+         * shutdown(), so listings can be cached per generation.
+         */
+        uint64_t getGeneration() const { return m_generation; }
+
+        /**
+         * @brief Rename a desktop
+         * @return false if the desktop does not exist
+         */
+        bool renameDesktop(const int id, std::string_view name);
+
+        /**
+         * @brief Publish desktop events to an event server
+         *
+         * Events: `vdesk>>SEQ,ID` on a switch, `vdeskcreated>>SEQ,ID,NAME`,
+         * `vdeskrenamed>>SEQ,ID,NAME` and `vdeskwindows>>SEQ,ID,WINDOWS,FULLSCREEN,URGENT`
+         * when a desktop's window counters change.
+         * @param server Server to publish to, nullptr to stop publishing
+         */
+        void setEventServer(CEventServer* server);
+
+        CLayout& getLayout() { return m_layout; }
+        const CLayout& getLayout() const { return m_layout; }
+
+        CWorkspaceReclaimer& getReclaimer() { return m_reclaimer; }
+
+        // Backend events (IBackendListener)
+
+        void onMonitorAdded(const SMonitorState& monitor) override;
+        void onMonitorRemoved(MONITORID id) override;
+        void onWorkspaceCreated(const SWorkspaceState& workspace) override;
+        void onWorkspaceDestroyed(WORKSPACEID id) override;
+        void onWorkspaceMoved(WORKSPACEID id, MONITORID monitorID) override;
+        void onWorkspaceActivated(MONITORID monitorID, WORKSPACEID id) override;
+        void onWindowOpened(const SWindowState& window) override;
+        void onWindowClosed(WINDOWID id) override;
+        void onWindowMoved(WINDOWID id, WORKSPACEID workspaceID) override;
+        void onWindowFullscreen(WINDOWID id, bool fullscreen) override;
+        void onWindowUrgent(WINDOWID id, bool urgent) override;
+
     private:
         CVirtualDesktopManager();
         ~CVirtualDesktopManager();
@@ -14,6 +211,95 @@ namespace VDM {
         CVirtualDesktopManager& operator=(const CVirtualDesktopManager&) = delete;
         CVirtualDesktopManager(CVirtualDesktopManager&&) = delete;
         CVirtualDesktopManager& operator=(CVirtualDesktopManager&&) = delete;
+
+        /**
+         * @brief Check that a workspace ID is neither reserved by a desktop nor held by a live workspace
+         */
+        bool isWorkspaceIDFree(const WORKSPACEID id);
+
+        /**
+         * @brief Free workspace ID in a desktop's range for a slot, not reserved by any other desktop
+         * @return Workspace ID, -1 if the range is full
+         */
+        WORKSPACEID reserveWorkspaceID(const CVirtualDesktop& desktop, const size_t slot);
+
+        /**
+         * @brief Reserve a workspace ID for every slot of a desktop that has none
+         */
+        void reserveWorkspaces(const CVirtualDesktop& desktop);
+
+        /**
+         * @brief Workspace of a desktop on a monitor slot, created if it is not live
+         * @return Workspace ID, -1 on failure
+         */
+        WORKSPACEID ensureWorkspace(const CVirtualDesktop& desktop, const size_t slot);
+
+        /**
+         * @brief Hand a desktop's live workspaces to the reclaimer, after it was left
+         */
+        void scheduleRelease(const CVirtualDesktop& desktop);
+
+        /**
+         * @brief Update the occupancy bit of the cell a workspace is assigned to
+         * @param id Workspace ID, -1 to recompute every cell
+         */
+        void refreshOccupancy(const WORKSPACEID id);
+
+        /**
+         * @brief Note that the window counters of a workspace changed
+         *
+         * Called by the workspace manager only for real changes, so clearing
+         * an urgent flag that was never set on each focus change does not get
+         * here. Bumps the generation if the workspace is in the layout and
+         * marks its desktop for publishWindowCounters().
+         * @param id Workspace ID, -1 for every desktop
+         */
+        void onCountersChanged(const WORKSPACEID id);
+
+        /**
+         * @brief Publish vdeskwindows for the desktops marked since the last call
+         *
+         * Runs after the workspace manager has applied the window event, so
+         * only the desktops the event touched are summed and compared.
+         */
+        void publishWindowCounters();
+
+        /**
+         * @brief Bump the generation if a workspace event concerns a workspace in the layout
+         */
+        void markChangedIfOwned(const WORKSPACEID id);
+
+        void markChanged() { ++m_generation; }
+
+        ICompositorBackend* m_pBackend = nullptr;
+        CLayout m_layout;
+        CWorkspaceReclaimer m_reclaimer;
+        SSwitchResult m_lastSwitch;
+
+        // Switch coalescing, see requestSwitch()
+        std::function<void(int)> m_switchTimerCallback;
+        std::chrono::milliseconds m_frameInterval = DEFAULT_FRAME_INTERVAL;
+        std::chrono::milliseconds m_instantThreshold{0};
+        std::chrono::steady_clock::time_point m_lastSwitchTime;
+        std::chrono::steady_clock::time_point m_lastRequestTime;
+        int m_pendingSwitch = -1;
+        bool m_pendingAnimate = true;
+        uint64_t m_switchRequestCount = 0;
+        uint64_t m_coalescedCount = 0;
+        uint64_t m_instantSwitchCount = 0;
+        uint64_t m_generation = 1;
+
+        CEventServer* m_pEventServer = nullptr;
+
+        // Desktops whose counters changed since the last publishWindowCounters(),
+        // as layout indices; a window event touches at most two
+        std::vector<uint32_t> m_changedDesktops;
+
+        // Last counters published per desktop, in layout order
+        std::vector<SWindowCounters> m_publishedCounters;
+
+        // Reused between switches so that a switch does not allocate
+        std::vector<SWorkspaceAssignment> m_assignments;
     }; // class CVirtualDesktopManager
 
-} // namespace VDM
\ No newline at end of file
+} // namespace VDM
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "VdmTypes.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VDM {
+
+    /**
+     * @brief Tracks which workspace IDs are in use and finds the lowest free one
+     *
+     * IDs are kept in a two-level bitmap: one bit per ID, plus one bit per
+     * 64-ID word telling whether that word is full. A lookup skips 4096 used
+     * IDs per summary word, so finding a free ID is O(1) amortized for the
+     * densely packed ID sets workspaces produce.
+     *
+     * Only regular workspaces are tracked: IDs below 1 (special workspaces)
+     * and above MAX_TRACKED_ID are ignored.
+     */
+    class CWorkspaceIDAllocator {
+    public:
+        static constexpr WORKSPACEID MAX_TRACKED_ID = 1 << 20;
+
+        /**
+         * @brief Lowest free ID in [first, last]
+         * @return Free ID, -1 if every ID in the range is in use
+         */
+        WORKSPACEID findFree(WORKSPACEID first = 1, WORKSPACEID last = MAX_TRACKED_ID) const;
+
+        void markUsed(const WORKSPACEID id);
+        void markFree(const WORKSPACEID id);
+        bool isUsed(const WORKSPACEID id) const;
+
+        static bool isTracked(const WORKSPACEID id) { return id >= 1 && id <= MAX_TRACKED_ID; }
+
+        /**
+         * @brief Forget every ID
+         */
+        void clear();
+
+        size_t getUsedCount() const { return m_usedCount; }
+
+    private:
+        static constexpr size_t BITS = 64;
+
+        /**
+         * @brief Index of the first word at or after @p word that has a free bit
+         */
+        size_t findNonFullWord(size_t word) const;
+
+        // Bit (id - 1) is set when the ID is in use
+        std::vector<uint64_t> m_words;
+        // Bit n is set when m_words[n] is full
+        std::vector<uint64_t> m_fullWords;
+        size_t m_usedCount = 0;
+
+    }; // class CWorkspaceIDAllocator
+
+} // namespace VDM
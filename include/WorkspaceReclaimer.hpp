@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CompositorBackend.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace VDM {
+
+/**
+ * @brief Deferred release of the workspaces of desktops that are not on screen
+ *
+ * A workspace the plugin created is kept alive by the backend until it is
+ * released. Releasing it the moment its desktop is left would re-create it on
+ * every flip back, so workspaces are only scheduled when their desktop is
+ * left, and released once they have stayed hidden for a grace period.
+ *
+ * dispatch() does the sweep. At most `budget` candidates are checked per call,
+ * so a long backlog is spread over several event loop iterations instead of
+ * stalling one frame. A candidate is released only if, when checked, it still
+ * exists, is not shown on any monitor and holds no windows; otherwise it is
+ * dropped until its desktop is left again.
+ */
+class CWorkspaceReclaimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds DEFAULT_GRACE_PERIOD{10000};
+    static constexpr size_t DEFAULT_BUDGET = 16;
+
+    explicit CWorkspaceReclaimer(ICompositorBackend* backend = nullptr) : m_pBackend(backend) {}
+
+    /**
+     * @brief Backend workspaces are released to; pending candidates are dropped
+     */
+    void setBackend(ICompositorBackend* backend);
+
+    /**
+     * @brief How long a workspace has to stay hidden before it is released
+     */
+    void setGracePeriod(std::chrono::milliseconds gracePeriod) { m_gracePeriod = gracePeriod; }
+
+    /**
+     * @brief Candidates checked per dispatch()
+     */
+    void setBudget(size_t budget) { m_budget = budget; }
+
+    /**
+     * @brief Hook to schedule a call to dispatch()
+     *
+     * Called with the delay in milliseconds whenever the next sweep is due,
+     * so the host can run dispatch() from its event loop. Without a timer,
+     * nothing is released until dispatch() is called.
+     */
+    void setTimerCallback(std::function<void(int)> callback) { m_timerCallback = std::move(callback); }
+
+    /**
+     * @brief Release a workspace once the grace period is over, restarting it if already scheduled
+     */
+    void schedule(WORKSPACEID id);
+
+    /**
+     * @brief Keep a workspace, e.g. because its desktop is shown again
+     */
+    void cancel(WORKSPACEID id);
+
+    /**
+     * @brief Release up to the budget of candidates whose grace period is over
+     */
+    void dispatch();
+
+    size_t getPendingCount() const { return m_pendingCount; }
+    uint64_t getReclaimedCount() const { return m_reclaimedCount; }
+
+    /**
+     * @brief Candidates dropped because they were gone, on screen or not empty when checked
+     */
+    uint64_t getKeptCount() const { return m_keptCount; }
+    uint64_t getSweepCount() const { return m_sweepCount; }
+
+private:
+    struct SCandidate {
+        WORKSPACEID id = -1;
+        Clock::time_point deadline;
+    };
+
+    bool isPending(const SCandidate& candidate) const;
+    void armTimer(Clock::time_point now);
+
+    ICompositorBackend* m_pBackend = nullptr;
+    std::chrono::milliseconds m_gracePeriod = DEFAULT_GRACE_PERIOD;
+    size_t m_budget = DEFAULT_BUDGET;
+    std::function<void(int)> m_timerCallback;
+
+    // Deadlines grow with scheduling order, so the queue is sorted by deadline.
+    // A rescheduled or cancelled workspace leaves a stale entry behind, told
+    // apart by its deadline no longer matching m_deadlines. Workspaces that
+    // are not pending keep their entry with a default deadline, so flipping
+    // between desktops does not allocate map nodes.
+    std::deque<SCandidate> m_queue;
+    std::unordered_map<WORKSPACEID, Clock::time_point> m_deadlines;
+    size_t m_pendingCount = 0;
+
+    // Reused between sweeps so that a sweep does not allocate
+    std::vector<WORKSPACEID> m_releases;
+
+    uint64_t m_reclaimedCount = 0;
+    uint64_t m_keptCount = 0;
+    uint64_t m_sweepCount = 0;
+};
+
+} // namespace VDM
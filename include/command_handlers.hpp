@@ -0,0 +1,65 @@
+#pragma once
+
+#include "VdmTypes.hpp"
+#include "Stats.hpp"
+
+#include <string>
+#include <string_view>
+
+namespace VDM::Commands {
+
+    // The plugin's only hyprctl command; features are its subcommands
+    const std::string CMD_DISPATCH_VDM_STR = "vdm";
+
+    /**
+     * Subcommand handler
+     * @param args Arguments after the subcommand name
+     */
+    using SubcommandFn = std::string (*)(eHyprCtlOutputFormat format, std::string_view args);
+
+    struct SSubcommand {
+        std::string_view name;
+        SubcommandFn fn = nullptr;
+        eStatOp stat = STAT_COUNT;
+    };
+
+    /**
+     * Entry point of `hyprctl vdm <subcommand> [args]`
+     * Looks the subcommand up in a compile-time perfect-hash table (see
+     * CPerfectHashTable) and runs it inside the per-request arena (see
+     * CRequestArena), so scratch allocations made while building the reply
+     * are dropped as soon as it has been returned. The whole request, arena
+     * included, is recorded in the subcommand's stats.
+     * @param args Request as received from hyprctl, with or without the leading "vdm"
+     */
+    std::string handleCommand(eHyprCtlOutputFormat format, std::string_view args);
+
+    /**
+     * Command handlers
+     * Compositor-independent, so they are part of vdm-core and can be driven
+     * by the mock backend as well as by hyprctl
+     */
+    std::string handleDbgPluginInfo(eHyprCtlOutputFormat format, std::string_view args);
+
+    /**
+     * List virtual desktops with their workspaces and window counters
+     * The output is cached per state generation (see
+     * CVirtualDesktopManager::getGeneration). With `since=<gen>` in the args
+     * and nothing changed since, only a short "unchanged" reply is returned.
+     */
+    std::string handleVirtualDesktopList(eHyprCtlOutputFormat format, std::string_view args);
+
+    /**
+     * Report the latency histograms and allocation counts (see Stats.hpp)
+     * Only operations that ran are listed. With `reset` in the args the
+     * stats are cleared instead.
+     */
+    std::string handleStats(eHyprCtlOutputFormat format, std::string_view args);
+
+    /**
+     * Control tracing (see Trace.hpp)
+     * `start` drops earlier events and starts recording; `stop <path>` stops
+     * and writes the events to <path> as Chrome trace-event JSON.
+     */
+    std::string handleTrace(eHyprCtlOutputFormat format, std::string_view args);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <hyprland/src/plugins/PluginAPI.hpp>
+#include <string>
+
+namespace VDM::Dispatchers {
+
+    // Dispatcher names, as used in hyprland.conf binds and `hyprctl dispatch`
+    inline constexpr const char* DISPATCH_VDESK_STR = "vdesk";
+
+    /**
+     * Switch all monitors to a virtual desktop
+     * @param args Desktop ID, 1 to CVirtualDesktopManager::MAX_DESKTOPS, or next-occupied / prev-occupied
+     *             for the next or previous desktop with windows
+     */
+    SDispatchResult dispatchVirtualDesktop(std::string args);
+
+    /**
+     * Register all dispatchers for the VDM plugin
+     * @param handle Plugin handle from PLUGIN_INIT
+     */
+    void registerAll(HANDLE handle);
+
+    /**
+     * Remove all dispatchers registered by registerAll()
+     * @param handle Plugin handle from PLUGIN_INIT
+     */
+    void unregisterAll(HANDLE handle);
+}
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <hyprland/src/plugins/PluginAPI.hpp>
+#include "VdmTypes.hpp"
 #include <format>
 
 // Plugin metadata
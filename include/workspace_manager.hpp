@@ -1,13 +1,18 @@
 #pragma once
 
-#include <hyprland/src/plugins/PluginAPI.hpp>
-#include <hyprland/src/Compositor.hpp>
-#include <hyprland/src/desktop/Workspace.hpp>
-#include <hyprland/src/helpers/Monitor.hpp>
+#include "CompositorBackend.hpp"
+#include "WorkspaceIDAllocator.hpp"
+#include "MonitorResolver.hpp"
+#include "NotificationScheduler.hpp"
+#include <algorithm>
+#include <functional>
+#include <string_view>
 #include <string>
 #include <vector>
 #include <optional>
+#include <span>
 #include <memory>
+#include <unordered_map>
 
 namespace VDM {
 
@@ -22,6 +27,25 @@ struct WorkspaceInfo {
     int32_t windowCount;
     bool isActive;
     bool hasFullscreen;
+    bool hasUrgent;
+};
+
+/**
+ * @brief Window counters of a workspace or a virtual desktop
+ */
+struct SWindowCounters {
+    uint32_t windows = 0;
+    uint32_t fullscreen = 0;
+    uint32_t urgent = 0;
+
+    SWindowCounters& operator+=(const SWindowCounters& other) {
+        windows += other.windows;
+        fullscreen += other.fullscreen;
+        urgent += other.urgent;
+        return *this;
+    }
+
+    bool operator==(const SWindowCounters&) const = default;
 };
 
 /**
@@ -41,6 +65,39 @@ struct MonitorInfo {
     std::vector<WORKSPACEID> workspaces;
 };
 
+/**
+ * @brief Non-owning counterpart of WorkspaceInfo
+ *
+ * Strings point into compositor and index state and are only valid until
+ * the next compositor event or mutation: consume the view inside the
+ * visitor or right after the query, and copy whatever has to be kept.
+ */
+struct SWorkspaceInfoView {
+    WORKSPACEID id = -1;
+    std::string_view name;
+    std::string_view monitorName;
+    MONITORID monitorID = -1;
+    SWindowCounters windows;
+    bool isActive = false;
+};
+
+/**
+ * @brief Non-owning counterpart of MonitorInfo, same lifetime rules as SWorkspaceInfoView
+ */
+struct SMonitorInfoView {
+    MONITORID id = -1;
+    std::string_view name;
+    std::string_view description;
+    int32_t width = 0;
+    int32_t height = 0;
+    float refreshRate = 0.f;
+    int32_t x = 0;
+    int32_t y = 0;
+    WORKSPACEID activeWorkspaceID = -1;
+    std::string_view activeWorkspaceName;
+    std::span<const WORKSPACEID> workspaces;
+};
+
 /**
  * @brief Layout information structure
  */
@@ -54,15 +111,69 @@ struct LayoutInfo {
  * 
  * This class provides a centralized interface for workspace management operations
  * including creation, deletion, workspace-to-monitor assignments, and querying
- * information about the current Hyprland configuration.
+ * information about the current Hyprland configuration. All compositor access
+ * goes through an ICompositorBackend, so the manager also runs against
+ * CMockBackend outside of Hyprland.
  */
-class CWorkspaceManager {
+class CWorkspaceManager : public IBackendListener {
 private:
     // Singleton instance
     static CWorkspaceManager* m_pInstance;
     
-    // Plugin handle for Hyprland API calls
-    HANDLE m_hHandle;
+    // Compositor backend all operations go through
+    ICompositorBackend* m_pBackend;
+
+    /**
+     * @brief Index entry for a workspace known to the manager
+     */
+    struct SWorkspaceIndexEntry {
+        MONITORID monitorID = -1;
+        SWindowCounters windows;
+    };
+
+    /**
+     * @brief Index entry for a mapped window
+     */
+    struct SWindowIndexEntry {
+        WORKSPACEID workspaceID = -1;
+        bool fullscreen = false;
+        bool urgent = false;
+    };
+
+    /**
+     * @brief Index entry for a monitor known to the manager
+     */
+    struct SMonitorIndexEntry {
+        std::string name;
+        WORKSPACEID activeWorkspaceID = -1;
+        std::vector<WORKSPACEID> workspaces;
+    };
+
+    // Workspace/monitor index, kept up to date from backend events so that
+    // queries never have to rescan the compositor state
+    std::unordered_map<WORKSPACEID, SWorkspaceIndexEntry> m_workspaceIndex;
+    std::unordered_map<MONITORID, SMonitorIndexEntry> m_monitorIndex;
+    std::unordered_map<WINDOWID, SWindowIndexEntry> m_windowIndex;
+
+    // Workspace IDs in use, kept in step with m_workspaceIndex
+    CWorkspaceIDAllocator m_idAllocator;
+
+    // IDs up to this one belong to someone else, see setReservedWorkspaceIDs()
+    WORKSPACEID m_lastReservedID = 0;
+
+    // Monitor selector lookup, kept in step with m_monitorIndex
+    CMonitorResolver m_monitorResolver;
+
+    // User-facing notifications, merged when operations come in bursts
+    CNotificationScheduler m_notifications;
+
+    // Told when a workspace gains its first window or loses its last one,
+    // and with -1 after a rebuild; fullscreen/urgent changes do not call it
+    std::function<void(WORKSPACEID)> m_occupancyCallback;
+
+    // Told whenever a workspace's window counters change, and with -1 after
+    // a rebuild; events that change nothing do not call it
+    std::function<void(WORKSPACEID)> m_countersCallback;
 
     // Private constructor for singleton
     CWorkspaceManager();
@@ -72,19 +183,50 @@ private:
     CWorkspaceManager& operator=(const CWorkspaceManager&) = delete;
 
     /**
-     * @brief Helper to get workspace by ID
+     * @brief Combine a backend view with what the index knows about it
      */
-    PHLWORKSPACE getWorkspaceByID(WORKSPACEID id);
+    SWorkspaceInfoView makeWorkspaceView(const SWorkspaceView& workspace) const;
+    SMonitorInfoView makeMonitorView(const SMonitorView& monitor) const;
+
+    static WorkspaceInfo toInfo(const SWorkspaceInfoView& view);
+    static MonitorInfo toInfo(const SMonitorInfoView& view);
+
+    // Index maintenance
 
     /**
-     * @brief Helper to get monitor by ID
+     * @brief Drop the index and rebuild it from a full compositor rescan
      */
-    CMonitor* getMonitorByID(MONITORID id);
+    void rebuildIndex();
+
+    void indexAddMonitor(const SMonitorState& monitor);
+    void indexRemoveMonitor(MONITORID id);
+    void indexAddWorkspace(WORKSPACEID id, MONITORID monitorID);
+    void indexRemoveWorkspace(WORKSPACEID id);
+    void indexMoveWorkspace(WORKSPACEID id, MONITORID monitorID);
+    void indexSetActiveWorkspace(MONITORID monitorID, WORKSPACEID id);
+
+    void indexAddWindow(const SWindowState& window);
+    void indexRemoveWindow(WINDOWID id);
 
     /**
-     * @brief Helper to get monitor by name
+     * @brief Add (+1) or remove (-1) a window's contribution to its workspace counters
      */
-    CMonitor* getMonitorByName(const std::string& name);
+    void applyWindowCounters(const SWindowIndexEntry& window, int sign);
+
+    /**
+     * @brief Refresh the active workspace of a monitor from the backend
+     */
+    void indexRefreshActiveWorkspace(MONITORID monitorID);
+
+    /**
+     * @brief Check whether a workspace is the active one on its monitor
+     */
+    bool isWorkspaceActive(WORKSPACEID id) const;
+
+    /**
+     * @brief Name of an indexed monitor, "unknown" if not indexed
+     */
+    const std::string& getIndexedMonitorName(MONITORID id) const;
 
 public:
     /**
@@ -99,10 +241,51 @@ public:
     static void destroy();
 
     /**
-     * @brief Initialize the workspace manager with plugin handle
-     * @param handle Plugin handle from PLUGIN_INIT
+     * @brief Initialize the workspace manager with a compositor backend
+     *
+     * Subscribes to the backend events that keep the workspace/monitor index
+     * up to date and builds the initial index from the compositor state.
+     * @param backend Backend to operate on, must outlive the manager
+     */
+    void initialize(ICompositorBackend* backend);
+
+    /**
+     * @brief Backend the manager operates on, nullptr before initialize()
+     */
+    ICompositorBackend* getBackend() const { return m_pBackend; }
+
+    /**
+     * @brief Notification scheduler shared by the VDM components
+     */
+    CNotificationScheduler& getNotifications() { return m_notifications; }
+
+    /**
+     * @brief Hook called when a workspace gains its first window or loses its last
+     *
+     * Window close and move events do not say which workspace a window left;
+     * the index knows, so it reports occupancy changes for the callers that
+     * keep derived state. Called with -1 after the index was rebuilt, when
+     * any workspace may have changed.
+     */
+    void setOccupancyCallback(std::function<void(WORKSPACEID)> callback) { m_occupancyCallback = std::move(callback); }
+
+    /**
+     * @brief Hook called with the ID of a workspace whose window counters changed, -1 for all
+     *
+     * Lets listeners update only what an event touched instead of rescanning
+     * every workspace.
+     */
+    void setCountersCallback(std::function<void(WORKSPACEID)> callback) { m_countersCallback = std::move(callback); }
+
+    /**
+     * @brief Compare the index against a full compositor rescan
+     *
+     * Window counters are checked against a full pass over the compositor's
+     * window list. Mismatches are logged and the index is rebuilt. Called on
+     * every query when the plugin is built with VDM_DEBUG_INDEX.
+     * @return true if the index matched the compositor state
      */
-    void initialize(HANDLE handle);
+    bool verifyIndex();
 
     // Workspace management operations
     
@@ -117,6 +300,10 @@ public:
 
     /**
      * @brief Delete a workspace by ID
+     *
+     * Only empty workspaces that are not on screen can be deleted. The plugin
+     * releases its references; the compositor destroys the workspace once
+     * nothing else holds it.
      * @param id Workspace ID
      * @return true if successful, false otherwise
      */
@@ -132,7 +319,7 @@ public:
     /**
      * @brief Move workspace to a specific monitor
      * @param workspaceID Workspace ID
-     * @param monitorID Monitor ID or monitor name
+     * @param monitorID Monitor name, ID, "desc:<substring>" or "current"
      * @return true if successful, false otherwise
      */
     bool moveWorkspaceToMonitor(WORKSPACEID workspaceID, const std::string& monitorID);
@@ -160,6 +347,61 @@ public:
      */
     std::optional<WorkspaceInfo> getWorkspaceInfo(WORKSPACEID id);
 
+    /**
+     * @brief Window, fullscreen and urgent counters of a workspace
+     *
+     * Maintained from window events, so this is O(1) and never walks the
+     * compositor's window list.
+     * @param id Workspace ID
+     * @return Counters, all zero if the workspace is unknown
+     */
+    SWindowCounters getWindowCounters(WORKSPACEID id) const;
+
+    // View queries: same data as above, without copying anything. The
+    // value-returning queries are wrappers around these
+
+    /**
+     * @brief Visit all workspaces, in compositor order
+     * @param fn Called once per workspace; must not create, move or destroy workspaces
+     */
+    void forEachWorkspace(CFunctionRef<void(const SWorkspaceInfoView&)> fn);
+
+    /**
+     * @brief View of a specific workspace
+     * @return nullopt if the workspace is not found
+     */
+    std::optional<SWorkspaceInfoView> getWorkspaceView(WORKSPACEID id);
+
+    /**
+     * @brief Visit all monitors, in compositor order
+     * @param fn Called once per monitor; must not plug or unplug monitors
+     */
+    void forEachMonitor(CFunctionRef<void(const SMonitorInfoView&)> fn);
+
+    /**
+     * @brief View of a specific monitor
+     * @param id Monitor name, ID, "desc:<substring>" or "current"
+     * @return nullopt if the monitor is not found
+     */
+    std::optional<SMonitorInfoView> getMonitorView(std::string_view id);
+
+    /**
+     * @brief Resolve a monitor selector
+     *
+     * Accepts a monitor name, a numeric ID, "desc:<substring>" or "current"
+     * (see CMonitorResolver). Only looks the selector up, so unlike
+     * getMonitorView() it never queries the backend.
+     * @return Monitor ID, or -1 if not found
+     */
+    MONITORID resolveMonitorID(std::string_view monitor);
+
+    /**
+     * @brief Workspaces on a monitor, straight from the index
+     * @param monitorID Monitor name, ID, "desc:<substring>" or "current"
+     * @return IDs, valid until the next workspace event; empty if not found
+     */
+    std::span<const WORKSPACEID> getWorkspacesOnMonitorView(std::string_view monitorID);
+
     /**
      * @brief Get active workspace ID
      * @return Active workspace ID, or -1 if none
@@ -168,7 +410,7 @@ public:
 
     /**
      * @brief Get workspaces on a specific monitor
-     * @param monitorID Monitor ID or name
+     * @param monitorID Monitor name, ID, "desc:<substring>" or "current"
      * @return Vector of workspace IDs
      */
     std::vector<WORKSPACEID> getWorkspacesOnMonitor(const std::string& monitorID);
@@ -183,16 +425,16 @@ public:
 
     /**
      * @brief Get information about a specific monitor
-     * @param id Monitor ID or name
+     * @param id Monitor name, ID, "desc:<substring>" or "current"
      * @return Optional MonitorInfo, nullopt if monitor not found
      */
     std::optional<MonitorInfo> getMonitorInfo(const std::string& id);
 
     /**
      * @brief Get the active monitor
-     * @return Pointer to active monitor, nullptr if none
+     * @return ID of the monitor under the cursor, -1 if none
      */
-    CMonitor* getActiveMonitor();
+    MONITORID getActiveMonitorID();
 
     /**
      * @brief Get monitor count
@@ -231,15 +473,54 @@ public:
 
     /**
      * @brief Get next available workspace ID
+     *
+     * Freed IDs are reused: this is the lowest ID not held by any workspace
+     * and past the reserved ones (see setReservedWorkspaceIDs).
      * @return Next available workspace ID
      */
     WORKSPACEID getNextAvailableWorkspaceID();
 
+    /**
+     * @brief Keep IDs 1..@p last out of getNextAvailableWorkspaceID()
+     *
+     * The virtual desktops reserve an ID range per desktop and only create
+     * the workspaces when a desktop is first shown; a workspace created
+     * without an ID must not take one of those.
+     * @param last Last reserved ID, 0 for none
+     */
+    void setReservedWorkspaceIDs(WORKSPACEID last) { m_lastReservedID = std::max<WORKSPACEID>(last, 0); }
+
+    /**
+     * @brief Get the lowest available workspace ID in a range
+     *
+     * Used to keep related workspaces (e.g. the ones of a virtual desktop)
+     * close together. Falls back to getNextAvailableWorkspaceID() when the
+     * range is full.
+     * @param first First ID of the range
+     * @param last Last ID of the range, inclusive
+     * @return Available workspace ID
+     */
+    WORKSPACEID getNextAvailableWorkspaceID(WORKSPACEID first, WORKSPACEID last);
+
     /**
      * @brief Get total window count across all workspaces
      * @return Total number of windows
      */
     size_t getTotalWindowCount();
+
+    // Backend events (IBackendListener)
+
+    void onMonitorAdded(const SMonitorState& monitor) override;
+    void onMonitorRemoved(MONITORID id) override;
+    void onWorkspaceCreated(const SWorkspaceState& workspace) override;
+    void onWorkspaceDestroyed(WORKSPACEID id) override;
+    void onWorkspaceMoved(WORKSPACEID id, MONITORID monitorID) override;
+    void onWorkspaceActivated(MONITORID monitorID, WORKSPACEID id) override;
+    void onWindowOpened(const SWindowState& window) override;
+    void onWindowClosed(WINDOWID id) override;
+    void onWindowMoved(WINDOWID id, WORKSPACEID workspaceID) override;
+    void onWindowFullscreen(WINDOWID id, bool fullscreen) override;
+    void onWindowUrgent(WINDOWID id, bool urgent) override;
 };
 
 } // namespace VDM
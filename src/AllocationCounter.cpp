@@ -0,0 +1,34 @@
+// Allocation counting for the plugin's stats, built with VDM_STATS_ALLOCS
+//
+// Replaces the global operator new inside the plugin module only: the module
+// is linked with -Bsymbolic, so its own calls bind to these definitions while
+// Hyprland keeps using the standard ones. Memory still comes from malloc, so
+// it can be freed on either side.
+
+#include "Stats.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+    thread_local uint64_t tAllocCount = 0;
+
+    void* countedAlloc(std::size_t size) {
+        ++tAllocCount;
+        if (void* p = std::malloc(size ? size : 1))
+            return p;
+        throw std::bad_alloc();
+    }
+
+    const bool gInstalled = [] {
+        VDM::Stats::setAllocationCounter([] { return tAllocCount; });
+        return true;
+    }();
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
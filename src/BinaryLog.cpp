@@ -0,0 +1,198 @@
+#include "BinaryLog.hpp"
+
+#include <deque>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <sys/mman.h>
+#include <time.h>
+#include <tuple>
+#include <unistd.h>
+
+namespace AppLog::binary {
+
+namespace {
+
+    // Sites live for the whole process: call sites cache pointers to them
+    std::mutex gSitesMutex;
+    std::deque<Site> gSites;
+    std::deque<std::string> gStrings;
+    std::map<std::tuple<const char*, uint8_t, std::string_view>, Site*> gSiteIndex;
+
+    // Writer state, guarded by gWriteMutex. Only the current chunk is mapped
+    std::mutex gWriteMutex;
+    int gFD = -1;
+    std::byte* gChunk = nullptr;
+    size_t gChunkOffset = 0;    // File offset of the mapped chunk
+    size_t gUsed = 0;           // Bytes used in the mapped chunk
+
+    uint64_t clockNs(clockid_t clock) {
+        timespec ts;
+        clock_gettime(clock, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    bool mapChunk(size_t offset) {
+        if (gChunk)
+            munmap(gChunk, CHUNK_SIZE);
+        gChunk = nullptr;
+
+        if (ftruncate(gFD, static_cast<off_t>(offset + CHUNK_SIZE)) == -1)
+            return false;
+
+        void* p = mmap(nullptr, CHUNK_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, gFD, static_cast<off_t>(offset));
+        if (p == MAP_FAILED)
+            return false;
+
+        gChunk = static_cast<std::byte*>(p);
+        gChunkOffset = offset;
+        gUsed = 0;
+        return true;
+    }
+
+    // Caller holds gWriteMutex
+    std::byte* reserveLocked(size_t size) {
+        if (!gChunk || size > CHUNK_SIZE)
+            return nullptr;
+
+        if (gUsed + size > CHUNK_SIZE) {
+            // The zero bytes left at the end of the chunk read as RECORD_END
+            if (!mapChunk(gChunkOffset + CHUNK_SIZE))
+                return nullptr;
+        }
+
+        std::byte* out = gChunk + gUsed;
+        gUsed += size;
+        return out;
+    }
+
+    std::byte* put(std::byte* out, const void* data, size_t size) {
+        std::memcpy(out, data, size);
+        return out + size;
+    }
+
+    std::byte* putString(std::byte* out, std::string_view value) {
+        const uint16_t length = static_cast<uint16_t>(std::min(value.size(), MAX_STRING));
+        out = put(out, &length, 2);
+        return put(out, value.data(), length);
+    }
+
+} // namespace
+
+namespace detail {
+
+    std::atomic<bool> gActive{false};
+    std::atomic<uint32_t> gEpoch{1};
+
+    std::byte* reserve(size_t size) {
+        gWriteMutex.lock();
+        std::byte* out = reserveLocked(size);
+        if (!out)
+            gWriteMutex.unlock();
+        return out;
+    }
+
+    void commit() {
+        gWriteMutex.unlock();
+    }
+
+    uint64_t now() {
+        return clockNs(CLOCK_MONOTONIC);
+    }
+
+    void defineSite(Site& site) {
+        const size_t size = 1 + 4 + 1 + 2 + std::min(site.category.size(), MAX_STRING) + 2 +
+                            std::min(site.format.size(), MAX_STRING) + 1 + site.argCount;
+
+        std::lock_guard lock(gWriteMutex);
+        const uint32_t epoch = gEpoch.load(std::memory_order_relaxed);
+        if (site.epoch.load(std::memory_order_relaxed) == epoch)
+            return;
+
+        std::byte* out = reserveLocked(size);
+        if (!out)
+            return;
+
+        *out++ = static_cast<std::byte>(RECORD_SITE);
+        out = put(out, &site.id, 4);
+        out = put(out, &site.level, 1);
+        out = putString(out, site.category);
+        out = putString(out, site.format);
+        out = put(out, &site.argCount, 1);
+        put(out, site.types, site.argCount);
+
+        site.epoch.store(epoch, std::memory_order_relaxed);
+    }
+
+} // namespace detail
+
+Site* registerSite(uint8_t level, std::string_view category, std::string_view format, const ArgType* types,
+                   uint8_t argCount) {
+    std::lock_guard lock(gSitesMutex);
+
+    const auto key = std::make_tuple(format.data(), level, category);
+    if (auto it = gSiteIndex.find(key); it != gSiteIndex.end())
+        return it->second;
+
+    // Format strings are literals, but keep copies so the index never dangles
+    auto& site = gSites.emplace_back();
+    site.id = static_cast<uint32_t>(gSites.size());
+    site.level = level;
+    site.category = gStrings.emplace_back(category);
+    site.format = gStrings.emplace_back(format);
+    site.types = types;
+    site.argCount = argCount;
+    site.epoch.store(0, std::memory_order_relaxed);
+
+    gSiteIndex.emplace(std::make_tuple(format.data(), level, site.category), &site);
+    return &site;
+}
+
+bool open(const char* path, std::string_view tag) {
+    close();
+
+    std::lock_guard lock(gWriteMutex);
+
+    gFD = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (gFD == -1)
+        return false;
+
+    if (!mapChunk(0)) {
+        ::close(gFD);
+        gFD = -1;
+        return false;
+    }
+
+    const uint64_t realtime = clockNs(CLOCK_REALTIME);
+    const uint64_t steady = clockNs(CLOCK_MONOTONIC);
+    std::byte* out = reserveLocked(sizeof(MAGIC) + 8 + 8 + 2 + std::min(tag.size(), MAX_STRING));
+    out = put(out, MAGIC, sizeof(MAGIC));
+    out = put(out, &realtime, 8);
+    out = put(out, &steady, 8);
+    putString(out, tag);
+
+    // Sites defined in a previous file have to be defined again in this one
+    detail::gEpoch.fetch_add(1, std::memory_order_relaxed);
+    detail::gActive.store(true, std::memory_order_release);
+    return true;
+}
+
+void close() {
+    detail::gActive.store(false, std::memory_order_release);
+
+    std::lock_guard lock(gWriteMutex);
+    if (gFD == -1)
+        return;
+
+    const size_t length = gChunkOffset + gUsed;
+    if (gChunk)
+        munmap(gChunk, CHUNK_SIZE);
+    gChunk = nullptr;
+
+    // If trimming fails the zero padding stays; the decoder skips it
+    (void)!ftruncate(gFD, static_cast<off_t>(length));
+    ::close(gFD);
+    gFD = -1;
+}
+
+} // namespace AppLog::binary
@@ -0,0 +1,244 @@
+#include "EventServer.hpp"
+#include "LoggerFacade.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace VDM {
+
+CEventServer::CEventServer() = default;
+
+CEventServer::~CEventServer() {
+    stop();
+}
+
+std::optional<std::string> CEventServer::getDefaultPath() {
+    const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+    const char* signature = std::getenv("HYPRLAND_INSTANCE_SIGNATURE");
+    if (!runtimeDir || !*runtimeDir || !signature || !*signature)
+        return std::nullopt;
+
+    return std::format("{}/hypr/{}/.vdm.sock", runtimeDir, signature);
+}
+
+bool CEventServer::start(const std::string& path) {
+    stop();
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        AppLog::error(AppLog::Category::Events, "Socket path too long: {}", path);
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    m_listenFD = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listenFD == -1) {
+        AppLog::error(AppLog::Category::Events, "socket() failed: {}", std::strerror(errno));
+        return false;
+    }
+
+    // A socket file left behind by a previous instance would make bind() fail
+    unlink(path.c_str());
+    if (bind(m_listenFD, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1 || listen(m_listenFD, 16) == -1) {
+        AppLog::error(AppLog::Category::Events, "Cannot listen on {}: {}", path, std::strerror(errno));
+        close(m_listenFD);
+        m_listenFD = -1;
+        return false;
+    }
+    m_path = path;
+
+    m_epollFD = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{.events = EPOLLIN, .data = {.fd = m_listenFD}};
+    if (m_epollFD == -1 || epoll_ctl(m_epollFD, EPOLL_CTL_ADD, m_listenFD, &ev) == -1) {
+        AppLog::error(AppLog::Category::Events, "epoll setup failed: {}", std::strerror(errno));
+        stop();
+        return false;
+    }
+
+    AppLog::info(AppLog::Category::Events, "Listening on {}", path);
+    return true;
+}
+
+void CEventServer::stop() {
+    for (auto& client : m_clients)
+        close(client.fd);
+    m_clients.clear();
+
+    if (m_epollFD != -1)
+        close(m_epollFD);
+    m_epollFD = -1;
+
+    if (m_listenFD != -1) {
+        close(m_listenFD);
+        unlink(m_path.c_str());
+    }
+    m_listenFD = -1;
+    m_path.clear();
+}
+
+void CEventServer::dispatch() {
+    if (m_epollFD == -1)
+        return;
+
+    epoll_event events[32];
+    int count;
+    while ((count = epoll_wait(m_epollFD, events, std::size(events), 0)) > 0) {
+        for (int i = 0; i < count; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == m_listenFD) {
+                acceptClients();
+                continue;
+            }
+
+            auto* client = findClient(fd);
+            if (!client)
+                continue;
+
+            bool alive = !(events[i].events & (EPOLLHUP | EPOLLERR));
+
+            // Clients have nothing to say; drain whatever they send and
+            // watch for EOF
+            if (alive && (events[i].events & (EPOLLIN | EPOLLRDHUP))) {
+                char buf[256];
+                ssize_t n;
+                while ((n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT)) > 0) {}
+                alive = n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+            }
+
+            if (alive && (events[i].events & EPOLLOUT))
+                alive = flush(*client);
+
+            if (!alive)
+                dropClient(fd);
+            else
+                updateInterest(*client);
+        }
+
+        if (count < static_cast<int>(std::size(events)))
+            break;
+    }
+}
+
+void CEventServer::publish(std::string_view event, std::string_view data) {
+    ++m_sequence;
+
+    if (m_clients.empty())
+        return;
+
+    char seq[24];
+    const auto [seqEnd, ec] = std::to_chars(seq, seq + sizeof(seq), m_sequence);
+
+    m_line.clear();
+    m_line.append(event);
+    m_line.append(">>");
+    m_line.append(seq, seqEnd);
+    m_line.push_back(',');
+    m_line.append(data);
+    m_line.push_back('\n');
+
+    // Collect first: dropping a client reorders m_clients
+    std::vector<int> dropped;
+    for (auto& client : m_clients) {
+        if (client.queue.size() - client.offset + m_line.size() > MAX_QUEUED_BYTES) {
+            dropped.push_back(client.fd);
+            ++m_droppedClients;
+            continue;
+        }
+
+        client.queue.append(m_line);
+        if (!flush(client))
+            dropped.push_back(client.fd);
+        else
+            updateInterest(client);
+    }
+
+    for (const int fd : dropped)
+        dropClient(fd);
+}
+
+void CEventServer::acceptClients() {
+    for (;;) {
+        const int fd = accept4(m_listenFD, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                AppLog::warn(AppLog::Category::Events, "accept() failed: {}", std::strerror(errno));
+            return;
+        }
+
+        epoll_event ev{.events = EPOLLIN | EPOLLRDHUP, .data = {.fd = fd}};
+        if (epoll_ctl(m_epollFD, EPOLL_CTL_ADD, fd, &ev) == -1) {
+            close(fd);
+            continue;
+        }
+
+        m_clients.emplace_back().fd = fd;
+    }
+}
+
+bool CEventServer::flush(SClient& client) {
+    while (client.offset < client.queue.size()) {
+        const ssize_t n = send(client.fd, client.queue.data() + client.offset, client.queue.size() - client.offset,
+                               MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0) {
+            client.offset += static_cast<size_t>(n);
+            continue;
+        }
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        return false;
+    }
+
+    if (client.offset == client.queue.size()) {
+        client.queue.clear();
+        client.offset = 0;
+    } else if (client.offset > MAX_QUEUED_BYTES / 2) {
+        // Compact now and then instead of on every partial write
+        client.queue.erase(0, client.offset);
+        client.offset = 0;
+    }
+
+    return true;
+}
+
+void CEventServer::updateInterest(SClient& client) {
+    const bool wantWrite = client.offset < client.queue.size();
+    if (wantWrite == client.wantWrite)
+        return;
+
+    epoll_event ev{.events = EPOLLIN | EPOLLRDHUP | (wantWrite ? EPOLLOUT : 0u), .data = {.fd = client.fd}};
+    epoll_ctl(m_epollFD, EPOLL_CTL_MOD, client.fd, &ev);
+    client.wantWrite = wantWrite;
+}
+
+CEventServer::SClient* CEventServer::findClient(int fd) {
+    auto it = std::find_if(m_clients.begin(), m_clients.end(), [fd](const auto& c) { return c.fd == fd; });
+    return it != m_clients.end() ? &*it : nullptr;
+}
+
+void CEventServer::dropClient(int fd) {
+    auto it = std::find_if(m_clients.begin(), m_clients.end(), [fd](const auto& c) { return c.fd == fd; });
+    if (it == m_clients.end())
+        return;
+
+    epoll_ctl(m_epollFD, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+
+    // Order does not matter: swap with the last client instead of shifting
+    *it = std::move(m_clients.back());
+    m_clients.pop_back();
+}
+
+} // namespace VDM
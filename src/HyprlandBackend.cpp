@@ -0,0 +1,528 @@
+#include "HyprlandBackend.hpp"
+#include "Stats.hpp"
+#include <hyprland/src/managers/LayoutManager.hpp>
+#include <hyprland/src/managers/EventManager.hpp>
+#include <hyprland/src/managers/input/InputManager.hpp>
+#include <any>
+#include <format>
+
+namespace VDM {
+
+CHyprlandBackend::CHyprlandBackend(HANDLE handle) : m_hHandle(handle) {}
+
+CHyprlandBackend::~CHyprlandBackend() = default;
+
+void CHyprlandBackend::init() {
+    registerCallbacks();
+
+    m_workspaceRefs.clear();
+    m_monitorRefs.clear();
+
+    if (!g_pCompositor)
+        return;
+
+    for (const auto& monitor : g_pCompositor->m_realMonitors) {
+        if (monitor)
+            m_monitorRefs[monitor->m_id] = monitor;
+    }
+
+    for (auto& workspace : g_pCompositor->getWorkspaces()) {
+        if (workspace)
+            m_workspaceRefs[workspace->m_id] = workspace;
+    }
+}
+
+void CHyprlandBackend::registerCallbacks() {
+    m_vCallbacks.clear();
+
+    m_vCallbacks.push_back(HyprlandAPI::registerCallbackDynamic(m_hHandle, "monitorAdded",
+        [this](void*, SCallbackInfo&, std::any data) {
+            VDM_STAT_SCOPE(STAT_EVENT_MONITOR_ADDED);
+            auto* monitor = std::any_cast<PHLMONITOR>(&data);
+            if (!monitor || !*monitor)
+                return;
+            m_monitorRefs[(*monitor)->m_id] = *monitor;
+            const auto state = toState(*monitor);
+            emit([&](IBackendListener& l) { l.onMonitorAdded(state); });
+        }));
+
+    m_vCallbacks.push_back(HyprlandAPI::registerCallbackDynamic(m_hHandle, "monitorRemoved",
+        [this](void*, SCallbackInfo&, std::any data) {
+            VDM_STAT_SCOPE(STAT_EVENT_MONITOR_REMOVED);
+            auto* monitor = std::any_cast<PHLMONITOR>(&data);
+            if (!monitor || !*monitor)
+                return;
+            const MONITORID id = (*monitor)->m_id;
+            m_monitorRefs.erase(id);
+            emit([&](IBackendListener& l) { l.onMonitorRemoved(id); });
+        }));
+
+    m_vCallbacks.push_back(HyprlandAPI::registerCallbackDynamic(m_hHandle, "createWorkspace",
+        [this](void*, SCallbackInfo&, std::any data) {
+            VDM_STAT_SCOPE(STAT_EVENT_WORKSPACE_CREATED);
+            auto* workspace = std::any_cast<CWorkspace*>(&data);
+            if (!workspace || !*workspace)
+                return;
+            auto pWorkspace = (*workspace)->m_self.lock();
+            if (!pWorkspace)
+                return;
+            m_workspaceRefs[pWorkspace->m_id] = pWorkspace;
+            const auto state = toState(pWorkspace);
+            emit([&](IBackendListener& l) { l.onWorkspaceCreated(state); });
+        }));
+
+    m_vCallbacks.push_back(HyprlandAPI::registerCallbackDynamic(m_hHandle, "destroyWorkspace",
+        [this](void*, SCallbackInfo&, std::any data) {
+            VDM_STAT_SCOPE(STAT_EVENT_WORKSPACE_DESTROYED);
+            auto* workspace = std::any_cast<CWorkspace*>(&data);
+            if (!workspace || !*workspace)
+                return;
+            const WORKSPACEID id = (*workspace)->m_id;
+            m_workspaceRefs.erase(id);
+            m_ownedWorkspaces.erase(id);
+            emit([&](IBackendListener& l) { l.onWorkspaceDestroyed(id); });
+        }));
+
+    m_vCallbacks.push_back(HyprlandAPI::registerCallbackDynamic(m_hHandle, "moveWorkspace",
+        [this](void*, SCallbackInfo&, std::any data) {
+            VDM_STAT_SCOPE(STAT_EVENT_WORKSPACE_MOVED);
+            auto* args = std::any_cast<std::vector<std::any>>(&data);
+            if (!args || args->size() < 2)
+                return;
+            auto* workspace = std::any_cast<PHLWORKSPACE>(&(*args)[0]);
+            auto* monitor = std::any_cast<PHLMONITOR>(&(*args)[1]);
+            if (!workspace || !*workspace || !monitor || !*monitor)
+                return;
+            const WORKSPACEID id = (*workspace)->m_id;
+            const MONITORID monitorID = (*monitor)->m_id;
+            emit([&](IBackendListener& l) { l.onWorkspaceMoved(id, monitorID); });
+        }));
+
+    m_vCallbacks.push_back(HyprlandAPI::registerCallbackDynamic(m_hHandle, "workspace",
+        [this](void*, SCallbackInfo&, std::any data) {
+            VDM_STAT_SCOPE(STAT_EVENT_WORKSPACE_ACTIVATED);
+            auto* workspace = std::any_cast<PHLWORKSPACE>(&data);
+            if (!workspace || !*workspace)
+                return;
+            const WORKSPACEID id = (*workspace)->m_id;
+            const MONITORID monitorID = (*workspace)->monitorID();
+            emit([&](IBackendListener& l) { l.onWorkspaceActivated(monitorID, id); });
+        }));
+
+    m_vCallbacks.push_back(HyprlandAPI::registerCallbackDynamic(m_hHandle, "openWindow",
+        [this](void*, SCallbackInfo&, std::any data) {
+            VDM_STAT_SCOPE(STAT_EVENT_WINDOW_OPENED);
+            auto* window = std::any_cast<PHLWINDOW>(&data);
+            if (!window || !*window)
+                return;
+            const auto state = toState(*window);
+            emit([&](IBackendListener& l) { l.onWindowOpened(state); });
+        }));
+
+    m_vCallbacks.push_back(HyprlandAPI::registerCallbackDynamic(m_hHandle, "closeWindow",
+        [this](void*, SCallbackInfo&, std::any data) {
+            VDM_STAT_SCOPE(STAT_EVENT_WINDOW_CLOSED);
+            auto* window = std::any_cast<PHLWINDOW>(&data);
+            if (!window || !*window)
+                return;
+            const WINDOWID id = windowID(*window);
+            emit([&](IBackendListener& l) { l.onWindowClosed(id); });
+        }));
+
+    m_vCallbacks.push_back(HyprlandAPI::registerCallbackDynamic(m_hHandle, "moveWindow",
+        [this](void*, SCallbackInfo&, std::any data) {
+            VDM_STAT_SCOPE(STAT_EVENT_WINDOW_MOVED);
+            auto* args = std::any_cast<std::vector<std::any>>(&data);
+            if (!args || args->size() < 2)
+                return;
+            auto* window = std::any_cast<PHLWINDOW>(&(*args)[0]);
+            auto* workspace = std::any_cast<PHLWORKSPACE>(&(*args)[1]);
+            if (!window || !*window || !workspace || !*workspace)
+                return;
+            const WINDOWID id = windowID(*window);
+            const WORKSPACEID workspaceID = (*workspace)->m_id;
+            emit([&](IBackendListener& l) { l.onWindowMoved(id, workspaceID); });
+        }));
+
+    m_vCallbacks.push_back(HyprlandAPI::registerCallbackDynamic(m_hHandle, "fullscreen",
+        [this](void*, SCallbackInfo&, std::any data) {
+            VDM_STAT_SCOPE(STAT_EVENT_WINDOW_FULLSCREEN);
+            auto* window = std::any_cast<PHLWINDOW>(&data);
+            if (!window || !*window)
+                return;
+            const WINDOWID id = windowID(*window);
+            const bool fullscreen = (*window)->isFullscreen();
+            emit([&](IBackendListener& l) { l.onWindowFullscreen(id, fullscreen); });
+        }));
+
+    m_vCallbacks.push_back(HyprlandAPI::registerCallbackDynamic(m_hHandle, "urgent",
+        [this](void*, SCallbackInfo&, std::any data) {
+            VDM_STAT_SCOPE(STAT_EVENT_WINDOW_URGENT);
+            auto* window = std::any_cast<PHLWINDOW>(&data);
+            if (!window || !*window)
+                return;
+            const WINDOWID id = windowID(*window);
+            emit([&](IBackendListener& l) { l.onWindowUrgent(id, true); });
+        }));
+
+    // Hyprland clears the urgent flag when a window gets focus
+    m_vCallbacks.push_back(HyprlandAPI::registerCallbackDynamic(m_hHandle, "activeWindow",
+        [this](void*, SCallbackInfo&, std::any data) {
+            VDM_STAT_SCOPE(STAT_EVENT_WINDOW_ACTIVATED);
+            auto* window = std::any_cast<PHLWINDOW>(&data);
+            if (!window || !*window)
+                return;
+            const WINDOWID id = windowID(*window);
+            emit([&](IBackendListener& l) { l.onWindowUrgent(id, false); });
+        }));
+}
+
+PHLWORKSPACE CHyprlandBackend::getWorkspaceByID(WORKSPACEID id) {
+    if (!g_pCompositor)
+        return nullptr;
+
+    if (auto it = m_workspaceRefs.find(id); it != m_workspaceRefs.end()) {
+        if (auto workspace = it->second.lock())
+            return workspace;
+    }
+
+    return g_pCompositor->getWorkspaceByID(id);
+}
+
+PHLMONITOR CHyprlandBackend::getMonitorByID(MONITORID id) {
+    if (!g_pCompositor)
+        return nullptr;
+
+    if (auto it = m_monitorRefs.find(id); it != m_monitorRefs.end()) {
+        if (auto monitor = it->second.lock())
+            return monitor;
+    }
+
+    return g_pCompositor->getMonitorFromID(id);
+}
+
+SMonitorState CHyprlandBackend::toState(const PHLMONITOR& monitor) {
+    SMonitorState state;
+    state.id = monitor->m_id;
+    state.name = monitor->m_name;
+    state.description = monitor->m_description;
+    state.width = monitor->m_size.x;
+    state.height = monitor->m_size.y;
+    state.refreshRate = monitor->m_refreshRate;
+    state.x = monitor->m_position.x;
+    state.y = monitor->m_position.y;
+    state.activeWorkspaceID = monitor->m_activeWorkspace ? monitor->m_activeWorkspace->m_id : -1;
+    return state;
+}
+
+SWorkspaceState CHyprlandBackend::toState(const PHLWORKSPACE& workspace) {
+    SWorkspaceState state;
+    state.id = workspace->m_id;
+    state.name = workspace->m_name;
+    state.monitorID = workspace->monitorID();
+    return state;
+}
+
+SWindowState CHyprlandBackend::toState(const PHLWINDOW& window) {
+    SWindowState state;
+    state.id = windowID(window);
+    state.workspaceID = window->m_workspace ? window->m_workspace->m_id : -1;
+    state.fullscreen = window->isFullscreen();
+    state.urgent = window->m_isUrgent;
+    return state;
+}
+
+SMonitorView CHyprlandBackend::toView(const PHLMONITOR& monitor) {
+    SMonitorView view;
+    view.id = monitor->m_id;
+    view.name = monitor->m_name;
+    view.description = monitor->m_description;
+    view.width = monitor->m_size.x;
+    view.height = monitor->m_size.y;
+    view.refreshRate = monitor->m_refreshRate;
+    view.x = monitor->m_position.x;
+    view.y = monitor->m_position.y;
+    view.activeWorkspaceID = monitor->m_activeWorkspace ? monitor->m_activeWorkspace->m_id : -1;
+    return view;
+}
+
+SWorkspaceView CHyprlandBackend::toView(const PHLWORKSPACE& workspace) {
+    SWorkspaceView view;
+    view.id = workspace->m_id;
+    view.name = workspace->m_name;
+    view.monitorID = workspace->monitorID();
+    return view;
+}
+
+// State queries
+
+std::vector<SMonitorState> CHyprlandBackend::getMonitors() {
+    std::vector<SMonitorState> monitors;
+
+    if (!g_pCompositor)
+        return monitors;
+
+    monitors.reserve(g_pCompositor->m_realMonitors.size());
+    for (const auto& monitor : g_pCompositor->m_realMonitors) {
+        if (monitor)
+            monitors.push_back(toState(monitor));
+    }
+
+    return monitors;
+}
+
+std::vector<SWorkspaceState> CHyprlandBackend::getWorkspaces() {
+    std::vector<SWorkspaceState> workspaces;
+
+    if (!g_pCompositor)
+        return workspaces;
+
+    workspaces.reserve(m_workspaceRefs.size());
+    for (auto& workspace : g_pCompositor->getWorkspaces()) {
+        if (workspace)
+            workspaces.push_back(toState(workspace.lock()));
+    }
+
+    return workspaces;
+}
+
+std::optional<SMonitorState> CHyprlandBackend::getMonitor(MONITORID id) {
+    auto monitor = getMonitorByID(id);
+    if (!monitor)
+        return std::nullopt;
+
+    return toState(monitor);
+}
+
+std::optional<SWorkspaceState> CHyprlandBackend::getWorkspace(WORKSPACEID id) {
+    auto workspace = getWorkspaceByID(id);
+    if (!workspace)
+        return std::nullopt;
+
+    return toState(workspace);
+}
+
+void CHyprlandBackend::forEachMonitor(CFunctionRef<void(const SMonitorView&)> fn) {
+    if (!g_pCompositor)
+        return;
+
+    for (const auto& monitor : g_pCompositor->m_realMonitors) {
+        if (monitor)
+            fn(toView(monitor));
+    }
+}
+
+void CHyprlandBackend::forEachWorkspace(CFunctionRef<void(const SWorkspaceView&)> fn) {
+    if (!g_pCompositor)
+        return;
+
+    for (auto& workspace : g_pCompositor->getWorkspaces()) {
+        if (workspace)
+            fn(toView(workspace.lock()));
+    }
+}
+
+std::optional<SMonitorView> CHyprlandBackend::getMonitorView(MONITORID id) {
+    auto monitor = getMonitorByID(id);
+    if (!monitor)
+        return std::nullopt;
+
+    return toView(monitor);
+}
+
+std::optional<SWorkspaceView> CHyprlandBackend::getWorkspaceView(WORKSPACEID id) {
+    auto workspace = getWorkspaceByID(id);
+    if (!workspace)
+        return std::nullopt;
+
+    return toView(workspace);
+}
+
+std::vector<SWindowState> CHyprlandBackend::getWindows() {
+    std::vector<SWindowState> windows;
+
+    if (!g_pCompositor)
+        return windows;
+
+    windows.reserve(g_pCompositor->m_windows.size());
+    for (const auto& window : g_pCompositor->m_windows) {
+        if (window && window->m_isMapped && window->m_workspace)
+            windows.push_back(toState(window));
+    }
+
+    return windows;
+}
+
+MONITORID CHyprlandBackend::getMonitorIDByName(std::string_view name) {
+    if (!g_pCompositor)
+        return -1;
+
+    auto monitor = g_pCompositor->getMonitorFromName(std::string{name});
+    return monitor ? monitor->m_id : -1;
+}
+
+MONITORID CHyprlandBackend::getFocusedMonitorID() {
+    if (!g_pCompositor)
+        return -1;
+
+    if (auto monitor = g_pCompositor->getMonitorFromCursor(); monitor)
+        return monitor->m_id;
+
+    for (const auto& monitor : g_pCompositor->m_realMonitors) {
+        if (monitor)
+            return monitor->m_id;
+    }
+
+    return -1;
+}
+
+WORKSPACEID CHyprlandBackend::getActiveWorkspaceID(MONITORID monitorID) {
+    auto monitor = getMonitorByID(monitorID);
+    if (!monitor || !monitor->m_activeWorkspace)
+        return -1;
+
+    return monitor->m_activeWorkspace->m_id;
+}
+
+std::string CHyprlandBackend::getCurrentLayout() {
+    if (!g_pLayoutManager)
+        return "unknown";
+
+    auto layout = g_pLayoutManager->getCurrentLayout();
+    return layout ? layout->getLayoutName() : "unknown";
+}
+
+// Mutations
+
+bool CHyprlandBackend::createWorkspace(WORKSPACEID id, MONITORID monitorID, const std::string& name) {
+    auto monitor = getMonitorByID(monitorID);
+    if (!monitor)
+        return false;
+
+    auto workspace = CWorkspace::create(id, monitor, name);
+    if (!workspace)
+        return false;
+
+    // Hyprland only keeps weak references to workspaces: hold a strong one so
+    // an empty workspace that is not on screen survives until we let it go
+    m_ownedWorkspaces[id] = workspace;
+    return true;
+}
+
+bool CHyprlandBackend::changeWorkspace(MONITORID monitorID, WORKSPACEID id) {
+    auto monitor = getMonitorByID(monitorID);
+    if (!monitor)
+        return false;
+
+    monitor->changeWorkspace(id);
+    return true;
+}
+
+bool CHyprlandBackend::changeWorkspaces(std::span<const SWorkspaceAssignment> assignments, bool animate) {
+    if (!g_pCompositor)
+        return false;
+
+    std::vector<std::pair<PHLMONITOR, PHLWORKSPACE>> changes;
+    changes.reserve(assignments.size());
+    for (const auto& assignment : assignments) {
+        auto monitor = getMonitorByID(assignment.monitorID);
+        auto workspace = getWorkspaceByID(assignment.workspaceID);
+        if (!monitor || !workspace)
+            return false;
+        if (monitor->m_activeWorkspace != workspace)
+            changes.emplace_back(monitor, workspace);
+    }
+
+    if (changes.empty())
+        return true;
+
+    // Apply every monitor as an internal change: no per-monitor IPC events,
+    // hooks, focus changes or cursor warps. The rest of what a non-internal
+    // CMonitor::changeWorkspace does is done here, the same way
+    for (auto& [monitor, workspace] : changes) {
+        if (workspace->monitorID() != monitor->m_id)
+            g_pCompositor->moveWorkspaceToMonitor(workspace, monitor, true);
+
+        // Same direction rule as Hyprland: a higher workspace ID slides in from the right
+        const auto oldWorkspace = monitor->m_activeWorkspace;
+        const bool toLeft = oldWorkspace && workspace->m_id > oldWorkspace->m_id;
+        if (oldWorkspace)
+            oldWorkspace->startAnim(false, toLeft, !animate);
+        workspace->startAnim(true, toLeft, !animate);
+
+        monitor->changeWorkspace(workspace, true, true, true);
+
+        // Pinned windows follow the monitor to its new workspace
+        if (oldWorkspace) {
+            for (const auto& window : g_pCompositor->m_windows) {
+                if (window && window->m_workspace == oldWorkspace && window->m_pinned)
+                    window->moveToWorkspace(workspace);
+            }
+        }
+    }
+
+    // Flush once for the whole switch
+    for (auto& [monitor, workspace] : changes) {
+        if (auto layout = g_pLayoutManager ? g_pLayoutManager->getCurrentLayout() : nullptr)
+            layout->recalculateMonitor(monitor->m_id);
+    }
+
+    if (g_pInputManager)
+        g_pInputManager->refocus();
+
+    for (auto& [monitor, workspace] : changes) {
+        g_pEventManager->postEvent(SHyprIPCEvent{"workspace", workspace->m_name});
+        g_pEventManager->postEvent(SHyprIPCEvent{"workspacev2", std::format("{},{}", workspace->m_id, workspace->m_name)});
+        EMIT_HOOK_EVENT("workspace", workspace);
+    }
+
+    return true;
+}
+
+bool CHyprlandBackend::moveWorkspaceToMonitor(WORKSPACEID id, MONITORID monitorID) {
+    auto workspace = getWorkspaceByID(id);
+    auto monitor = getMonitorByID(monitorID);
+    if (!workspace || !monitor)
+        return false;
+
+    g_pCompositor->moveWorkspaceToMonitor(workspace, monitor);
+    return true;
+}
+
+bool CHyprlandBackend::renameWorkspace(WORKSPACEID id, const std::string& name) {
+    auto workspace = getWorkspaceByID(id);
+    if (!workspace)
+        return false;
+
+    workspace->m_name = name;
+    return true;
+}
+
+void CHyprlandBackend::releaseWorkspaces(std::span<const WORKSPACEID> ids) {
+    bool released = false;
+    for (const WORKSPACEID id : ids)
+        released |= m_ownedWorkspaces.erase(id) > 0;
+
+    // Without our reference Hyprland destroys the empty, hidden ones on its
+    // next sanity check; run it now so they go away in one batch
+    if (released && g_pCompositor)
+        g_pCompositor->sanityCheckWorkspaces();
+}
+
+// User feedback
+
+void CHyprlandBackend::notify(const std::string& message, eNotifyLevel level, int durationMs) {
+    if (!m_hHandle)
+        return;
+
+    CHyprColor color(0.2, 0.8, 0.2, 1.0);
+    switch (level) {
+        case NOTIFY_OK:    color = CHyprColor(0.2, 0.8, 0.2, 1.0); break;
+        case NOTIFY_WARN:  color = CHyprColor(0.8, 0.5, 0.2, 1.0); break;
+        case NOTIFY_ERROR: color = CHyprColor(0.8, 0.2, 0.2, 1.0); break;
+    }
+
+    HyprlandAPI::addNotification(m_hHandle, message, color, durationMs);
+}
+
+} // namespace VDM
@@ -1,8 +1,163 @@
 #include "Layout.hpp"
 
+#include <algorithm>
+
 namespace VDM {
 
     CLayout::CLayout() = default;
     CLayout::~CLayout() = default;
 
-} // namespace VDM
\ No newline at end of file
+    CVirtualDesktop& CLayout::createDesktop(std::optional<std::string_view> name) {
+        m_virtualDesktops.emplace_back(++m_vdeskCounter, name);
+        m_workspaces.resize(m_virtualDesktops.size() * m_stride, -1);
+        rebindRows();
+
+        m_occupied.resize(m_virtualDesktops.size());
+        for (auto& occupied : m_slotOccupied)
+            occupied.resize(m_virtualDesktops.size());
+        return m_virtualDesktops.back();
+    }
+
+    std::optional<size_t> CLayout::indexOf(const int id) const {
+        // Desktop IDs are handed out sequentially from 1, so they double as indices
+        if (id >= 1 && static_cast<size_t>(id) <= m_virtualDesktops.size() && m_virtualDesktops[id - 1].getID() == id)
+            return static_cast<size_t>(id - 1);
+
+        auto it = std::find_if(m_virtualDesktops.begin(), m_virtualDesktops.end(),
+                               [id](const auto& desktop) { return desktop.getID() == id; });
+        if (it == m_virtualDesktops.end())
+            return std::nullopt;
+        return static_cast<size_t>(it - m_virtualDesktops.begin());
+    }
+
+    CVirtualDesktop* CLayout::findDesktop(const int id) {
+        const auto index = indexOf(id);
+        return index ? &m_virtualDesktops[*index] : nullptr;
+    }
+
+    const CVirtualDesktop* CLayout::findDesktop(const int id) const {
+        const auto index = indexOf(id);
+        return index ? &m_virtualDesktops[*index] : nullptr;
+    }
+
+    CVirtualDesktop* CLayout::findDesktopByWorkspace(const WORKSPACEID id) {
+        const auto cell = findWorkspace(id);
+        return cell ? &m_virtualDesktops[cell->desktop] : nullptr;
+    }
+
+    std::optional<CLayout::SCell> CLayout::findWorkspace(const WORKSPACEID id) const {
+        auto it = m_workspaceCells.find(id);
+        if (it == m_workspaceCells.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    void CLayout::setActiveDesktopID(const int id) {
+        if (auto* previous = getActiveDesktop())
+            previous->setActive(false);
+
+        m_activeDesktopID = id;
+
+        if (auto* current = getActiveDesktop())
+            current->setActive(true);
+    }
+
+    WORKSPACEID CLayout::getWorkspaceID(const int desktopID, const size_t slot) const {
+        const auto* desktop = findDesktop(desktopID);
+        return desktop ? desktop->getWorkspaceID(slot) : -1;
+    }
+
+    bool CLayout::setWorkspaceID(const int desktopID, const size_t slot, const WORKSPACEID id) {
+        const auto index = indexOf(desktopID);
+        if (!index || slot >= m_slots.size())
+            return false;
+
+        WORKSPACEID& target = cell(*index, slot);
+        if (target == id)
+            return true;
+
+        if (target != -1)
+            m_workspaceCells.erase(target);
+
+        if (id != -1) {
+            // A workspace lives in one cell only
+            auto [it, inserted] = m_workspaceCells.try_emplace(id, SCell{});
+            if (!inserted)
+                cell(it->second.desktop, it->second.slot) = -1;
+            it->second = {.desktop = static_cast<uint32_t>(*index), .slot = static_cast<uint32_t>(slot)};
+        }
+
+        target = id;
+        return true;
+    }
+
+    void CLayout::setOccupied(const SCell& cell, const bool occupied) {
+        if (cell.slot >= m_slotOccupied.size())
+            return;
+
+        m_slotOccupied[cell.slot].set(cell.desktop, occupied);
+
+        bool any = occupied;
+        for (size_t slot = 0; !any && slot < m_slotOccupied.size(); ++slot)
+            any = m_slotOccupied[slot].test(cell.desktop);
+        m_occupied.set(cell.desktop, any);
+    }
+
+    size_t CLayout::attachMonitor(const MONITORID id, const std::string& name) {
+        if (auto slot = getSlot(id))
+            return *slot;
+
+        auto it = std::find_if(m_slots.begin(), m_slots.end(),
+                               [&name](const auto& slot) { return slot.monitorID == -1 && slot.name == name; });
+        if (it == m_slots.end()) {
+            reserveSlots(m_slots.size() + 1);
+            it = m_slots.insert(m_slots.end(), SMonitorSlot{.name = name});
+            rebindRows();
+            m_slotOccupied.emplace_back().resize(m_virtualDesktops.size());
+        }
+
+        it->monitorID = id;
+        return static_cast<size_t>(it - m_slots.begin());
+    }
+
+    void CLayout::detachMonitor(const MONITORID id) {
+        for (auto& slot : m_slots) {
+            if (slot.monitorID == id)
+                slot.monitorID = -1;
+        }
+    }
+
+    std::optional<size_t> CLayout::getSlot(const MONITORID id) const {
+        if (id == -1)
+            return std::nullopt;
+
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            if (m_slots[i].monitorID == id)
+                return i;
+        }
+        return std::nullopt;
+    }
+
+    void CLayout::reserveSlots(const size_t slots) {
+        if (slots <= m_stride)
+            return;
+
+        // Grow geometrically so that plugging in monitors one by one does not
+        // re-layout the matrix every time
+        const size_t stride = std::max<size_t>({slots, m_stride * 2, 4});
+        std::vector<WORKSPACEID> workspaces(m_virtualDesktops.size() * stride, -1);
+        for (size_t desktop = 0; desktop < m_virtualDesktops.size(); ++desktop) {
+            std::copy_n(m_workspaces.begin() + static_cast<std::ptrdiff_t>(desktop * m_stride), m_stride,
+                        workspaces.begin() + static_cast<std::ptrdiff_t>(desktop * stride));
+        }
+
+        m_workspaces = std::move(workspaces);
+        m_stride = stride;
+    }
+
+    void CLayout::rebindRows() {
+        for (size_t desktop = 0; desktop < m_virtualDesktops.size(); ++desktop)
+            m_virtualDesktops[desktop].m_workspaceIds = {m_workspaces.data() + desktop * m_stride, m_slots.size()};
+    }
+
+} // namespace VDM
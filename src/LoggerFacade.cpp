@@ -1,11 +1,15 @@
 
 #include "LoggerFacade.hpp"
 
+#include <algorithm>
 #include <atomic>
+#include <bit>
+#include <cstring>
+#include <memory>
 #include <mutex>
 #include <filesystem>
 #include <string>
-#include <hyprland/src/debug/log/Logger.hpp>
+#include <thread>
 namespace {
     // Real HU logger instance (internally thread-safe)
     CLI::CLogger gHuLogger;
@@ -23,9 +27,10 @@ namespace {
         target.append("] ");
     }
 
-    std::string buildDecoratedMessage(const std::string_view& msg,
-                                      std::optional<std::string_view> tag,
-                                      std::optional<std::string_view> category) {
+    // Decorates into a per-thread buffer, so a warm logger does not allocate
+    const std::string& buildDecoratedMessage(const std::string_view& msg,
+                                             std::optional<std::string_view> tag,
+                                             std::optional<std::string_view> category) {
         const bool hasCategory = category && !category->empty();
         const bool hasOverrideTag = tag && !tag->empty();
         const bool hasAnyTag = hasOverrideTag || !gDefaultTag.empty();
@@ -36,7 +41,8 @@ namespace {
         if (hasAnyTag)
             reserve += (hasOverrideTag ? tag->size() : gDefaultTag.size()) + BRACKETS_OVERHEAD;
 
-        std::string decorated;
+        thread_local std::string decorated;
+        decorated.clear();
         decorated.reserve(reserve);
 
         if (hasCategory)
@@ -51,6 +57,179 @@ namespace {
         return decorated;
     }
 
+    /**
+     * Bounded MPSC ring of log records drained by a background thread
+     *
+     * Producers claim a slot with a CAS on the tail and publish it through the
+     * slot's sequence number (Vyukov's bounded queue); the single consumer
+     * needs no atomics on the head beyond publishing it for flush(). The
+     * flusher sleeps on m_wakeups when the ring is empty, and producers only
+     * touch that futex when it is actually asleep.
+     */
+    class CAsyncSink {
+    public:
+        static constexpr size_t MAX_TEXT = 480;
+
+        CAsyncSink(size_t capacity, AppLog::OverflowPolicy overflow)
+            : m_capacity(std::bit_ceil(std::max<size_t>(capacity, 2))), m_mask(m_capacity - 1), m_overflow(overflow),
+              m_slots(std::make_unique<SSlot[]>(m_capacity)) {
+            for (size_t i = 0; i < m_capacity; ++i)
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            m_thread = std::thread([this] { run(); });
+        }
+
+        ~CAsyncSink() {
+            m_stop.store(true, std::memory_order_seq_cst);
+            wake();
+            m_thread.join();
+        }
+
+        void push(CLI::eLogLevel level, const std::string_view& msg, std::optional<std::string_view> tag,
+                  std::optional<std::string_view> category) {
+            uint64_t pos = m_tail.load(std::memory_order_relaxed);
+            SSlot* slot;
+            for (;;) {
+                slot = &m_slots[pos & m_mask];
+                const uint64_t seq = slot->sequence.load(std::memory_order_acquire);
+                const int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+                if (diff == 0) {
+                    if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                } else if (diff < 0) {
+                    // Full
+                    if (m_overflow == AppLog::OverflowPolicy::Drop) {
+                        m_dropped.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    wake();
+                    std::this_thread::yield();
+                    pos = m_tail.load(std::memory_order_relaxed);
+                } else {
+                    pos = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+
+            slot->level = level;
+            slot->length = decorate(slot->text, msg, tag, category);
+            slot->sequence.store(pos + 1, std::memory_order_release);
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_sleeping.load(std::memory_order_relaxed))
+                wake();
+        }
+
+        void flush() {
+            const uint64_t target = m_tail.load(std::memory_order_acquire);
+            while (m_head.load(std::memory_order_acquire) < target) {
+                wake();
+                std::this_thread::yield();
+            }
+        }
+
+        uint64_t getDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        struct alignas(64) SSlot {
+            std::atomic<uint64_t> sequence{0};
+            CLI::eLogLevel level{};
+            size_t length = 0;
+            char text[MAX_TEXT];
+        };
+
+        static size_t append(char* out, size_t used, std::string_view value) {
+            const size_t n = std::min(value.size(), MAX_TEXT - used);
+            std::memcpy(out + used, value.data(), n);
+            return used + n;
+        }
+
+        // Same layout as buildDecoratedMessage, written straight into the slot
+        static size_t decorate(char* out, const std::string_view& msg, std::optional<std::string_view> tag,
+                               std::optional<std::string_view> category) {
+            size_t used = 0;
+            if (category && !category->empty())
+                used = append(out, append(out, append(out, used, "["), *category), "] ");
+
+            if (tag && !tag->empty())
+                used = append(out, append(out, append(out, used, "["), *tag), "] ");
+            else if (!gDefaultTag.empty())
+                used = append(out, append(out, append(out, used, "["), gDefaultTag), "] ");
+
+            return append(out, used, msg);
+        }
+
+        void wake() {
+            m_wakeups.fetch_add(1, std::memory_order_release);
+            m_wakeups.notify_one();
+        }
+
+        // Write out everything published so far, returns the number of records
+        size_t drain() {
+            uint64_t head = m_head.load(std::memory_order_relaxed);
+            size_t count = 0;
+            for (;;) {
+                SSlot& slot = m_slots[head & m_mask];
+                if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+                    break;
+
+                gHuLogger.log(slot.level, std::string_view{slot.text, slot.length});
+                slot.sequence.store(head + m_capacity, std::memory_order_release);
+                ++head;
+                ++count;
+            }
+            m_head.store(head, std::memory_order_release);
+
+            const uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+            if (dropped != m_reportedDropped) {
+                gHuLogger.log(AppLog::LVL_WARN, std::string_view{"Log queue full, " + std::to_string(dropped - m_reportedDropped) + " records dropped"});
+                m_reportedDropped = dropped;
+            }
+
+            return count;
+        }
+
+        bool isEmpty() const {
+            const uint64_t head = m_head.load(std::memory_order_relaxed);
+            return m_slots[head & m_mask].sequence.load(std::memory_order_acquire) != head + 1;
+        }
+
+        void run() {
+            for (;;) {
+                if (drain() > 0)
+                    continue;
+                if (m_stop.load(std::memory_order_seq_cst))
+                    break;
+
+                const uint32_t ticket = m_wakeups.load(std::memory_order_acquire);
+                m_sleeping.store(true, std::memory_order_seq_cst);
+                if (isEmpty() && !m_stop.load(std::memory_order_seq_cst))
+                    m_wakeups.wait(ticket, std::memory_order_acquire);
+                m_sleeping.store(false, std::memory_order_relaxed);
+            }
+
+            drain();
+        }
+
+        const size_t m_capacity;
+        const size_t m_mask;
+        const AppLog::OverflowPolicy m_overflow;
+        std::unique_ptr<SSlot[]> m_slots;
+
+        alignas(64) std::atomic<uint64_t> m_tail{0};
+        alignas(64) std::atomic<uint64_t> m_head{0};
+        std::atomic<uint32_t> m_wakeups{0};
+        std::atomic<bool> m_sleeping{false};
+        std::atomic<bool> m_stop{false};
+        std::atomic<uint64_t> m_dropped{0};
+        uint64_t m_reportedDropped = 0;
+
+        std::thread m_thread;
+    };
+
+    // Set while async mode is on; swapped only by setAsyncOptions
+    std::unique_ptr<CAsyncSink> gAsyncSink;
+    AppLog::AsyncOptions gAsyncOptions;
+    uint64_t gDroppedBeforeShutdown = 0;
+
     void logErrorMessage(std::string message) {
         gHuLogger.log(AppLog::LVL_ERR, message);
     }
@@ -126,6 +305,11 @@ namespace AppLog {
                     std::optional<std::string_view> tagOverride,
                     std::optional<std::string_view> category)
     {
+        if (gAsyncSink) {
+            gAsyncSink->push(level, msg, tagOverride, category);
+            return;
+        }
+
         const bool hasCategory = category && !category->empty();
         const bool hasOverrideTag = tagOverride && !tagOverride->empty();
         const bool hasAnyTag = hasOverrideTag || !gDefaultTag.empty();
@@ -135,12 +319,11 @@ namespace AppLog {
             return;
         }
         
-        const std::string finalMsg = buildDecoratedMessage(msg, tagOverride, category);
-        gHuLogger.log(level, finalMsg);
-        gHuLogger.log(CLI::eLogLevel::LOG_TRACE, (std::string_view)"sono entrato nel log function");
+        gHuLogger.log(level, buildDecoratedMessage(msg, tagOverride, category));
     }
 
-    void initLogging(bool toStdout, bool colored, const char* filePath, const std::string_view& tag) {
+    void initLogging(bool toStdout, bool colored, const char* filePath, const std::string_view& tag,
+                     const AsyncOptions& async) {
         std::call_once(gInitOnce, [&]{
             gHuLogger.setEnableRolling(true);
             if (toStdout) {
@@ -151,6 +334,76 @@ namespace AppLog {
             gHuLogger.log(LVL_INFO, "Logging initialized");        
         });
         gDefaultTag = std::string(tag);
+
+        if (async.enabled && !gAsyncSink)
+            setAsyncOptions(async);
+    }
+
+    void setAsyncOptions(const AsyncOptions& async) {
+        if (gAsyncSink && async.enabled && async.capacity == gAsyncOptions.capacity && async.overflow == gAsyncOptions.overflow)
+            return;
+
+        if (gAsyncSink) {
+            gAsyncSink->flush();
+            gDroppedBeforeShutdown += gAsyncSink->getDropped();
+            gAsyncSink.reset();
+        }
+
+        gAsyncOptions = async;
+        if (async.enabled)
+            gAsyncSink = std::make_unique<CAsyncSink>(async.capacity, async.overflow);
+    }
+
+    void flushLogging() {
+        if (gAsyncSink)
+            gAsyncSink->flush();
+    }
+
+    void shutdownLogging() {
+        closeBinaryLog();
+        setAsyncOptions({});
+    }
+
+    bool openBinaryLog(const char* path) {
+        if (!path || !*path)
+            return false;
+
+        if (!binary::open(path, gDefaultTag)) {
+            logErrorMessage(std::string("Failed to open binary log '") + path + "'");
+            return false;
+        }
+        return true;
+    }
+
+    void closeBinaryLog() {
+        binary::close();
+    }
+
+    uint64_t getDroppedCount() {
+        return gDroppedBeforeShutdown + (gAsyncSink ? gAsyncSink->getDropped() : 0);
+    }
+
+    namespace detail {
+        std::atomic<uint32_t> gCategoryMask{~0u};
+
+        std::string& formatBuffer() {
+            thread_local std::string buffer;
+            return buffer;
+        }
+
+        void emit(LogLevel lvl, Category category) {
+            const std::string_view name = categoryName(category);
+            getLogger().log(toUnderlying(lvl), formatBuffer(), std::nullopt,
+                            name.empty() ? std::nullopt : std::make_optional(name));
+        }
+    }
+
+    void setCategoryEnabled(Category category, bool enabled) {
+        const uint32_t bit = 1u << static_cast<uint32_t>(category);
+        if (enabled)
+            detail::gCategoryMask.fetch_or(bit, std::memory_order_relaxed);
+        else
+            detail::gCategoryMask.fetch_and(~bit, std::memory_order_relaxed);
     }
 
     void setMinLevel(LogLevel lvl) { gMinLevel.store(lvl, std::memory_order_relaxed); }
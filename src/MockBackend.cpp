@@ -0,0 +1,358 @@
+#include "MockBackend.hpp"
+
+#include <algorithm>
+
+namespace VDM {
+
+CMockBackend::CMockBackend() = default;
+CMockBackend::~CMockBackend() = default;
+
+SMonitorView CMockBackend::toView(const SMonitorState& monitor) {
+    return {.id = monitor.id,
+            .name = monitor.name,
+            .description = monitor.description,
+            .width = monitor.width,
+            .height = monitor.height,
+            .refreshRate = monitor.refreshRate,
+            .x = monitor.x,
+            .y = monitor.y,
+            .activeWorkspaceID = monitor.activeWorkspaceID};
+}
+
+SWorkspaceView CMockBackend::toView(const SWorkspaceState& workspace) {
+    return {.id = workspace.id, .name = workspace.name, .monitorID = workspace.monitorID};
+}
+
+SMonitorState* CMockBackend::findMonitor(MONITORID id) {
+    auto it = std::find_if(m_monitors.begin(), m_monitors.end(), [id](const auto& m) { return m.id == id; });
+    return it != m_monitors.end() ? &*it : nullptr;
+}
+
+SWorkspaceState* CMockBackend::findWorkspace(WORKSPACEID id) {
+    auto it = std::find_if(m_workspaces.begin(), m_workspaces.end(), [id](const auto& w) { return w.id == id; });
+    return it != m_workspaces.end() ? &*it : nullptr;
+}
+
+WORKSPACEID CMockBackend::nextFreeWorkspaceID() const {
+    WORKSPACEID maxID = 0;
+    for (const auto& workspace : m_workspaces)
+        maxID = std::max(maxID, workspace.id);
+    return maxID + 1;
+}
+
+// Simulation controls
+
+MONITORID CMockBackend::addMonitor(const std::string& name, int32_t width, int32_t height) {
+    const MONITORID id = m_nextMonitorID++;
+
+    SMonitorState monitor;
+    monitor.id = id;
+    monitor.name = name;
+    monitor.description = "Mock monitor " + name;
+    monitor.width = width;
+    monitor.height = height;
+    monitor.refreshRate = 60.f;
+    monitor.x = m_monitors.empty() ? 0 : m_monitors.back().x + m_monitors.back().width;
+    m_monitors.push_back(monitor);
+
+    if (m_focusedMonitorID == -1)
+        m_focusedMonitorID = id;
+
+    // Like Hyprland, a new monitor gets a workspace before it is announced
+    const WORKSPACEID workspaceID = nextFreeWorkspaceID();
+    createWorkspace(workspaceID, id, std::to_string(workspaceID));
+    findMonitor(id)->activeWorkspaceID = workspaceID;
+
+    const SMonitorState state = *findMonitor(id);
+    emit([&](IBackendListener& l) { l.onMonitorAdded(state); });
+
+    return id;
+}
+
+void CMockBackend::removeMonitor(MONITORID id) {
+    if (!findMonitor(id))
+        return;
+
+    std::erase_if(m_monitors, [id](const auto& m) { return m.id == id; });
+    SMonitorState* backup = m_monitors.empty() ? nullptr : &m_monitors.front();
+
+    for (auto& workspace : m_workspaces) {
+        if (workspace.monitorID != id)
+            continue;
+
+        workspace.monitorID = backup ? backup->id : -1;
+        if (backup) {
+            const WORKSPACEID workspaceID = workspace.id;
+            const MONITORID backupID = backup->id;
+            emit([&](IBackendListener& l) { l.onWorkspaceMoved(workspaceID, backupID); });
+        }
+    }
+
+    if (m_focusedMonitorID == id)
+        m_focusedMonitorID = backup ? backup->id : -1;
+
+    emit([&](IBackendListener& l) { l.onMonitorRemoved(id); });
+}
+
+void CMockBackend::destroyWorkspace(WORKSPACEID id) {
+    if (!findWorkspace(id))
+        return;
+
+    for (auto it = m_windows.begin(); it != m_windows.end();) {
+        if (it->second.workspaceID != id) {
+            ++it;
+            continue;
+        }
+        const WINDOWID windowID = it->first;
+        it = m_windows.erase(it);
+        emit([&](IBackendListener& l) { l.onWindowClosed(windowID); });
+    }
+
+    std::erase_if(m_workspaces, [id](const auto& w) { return w.id == id; });
+
+    for (auto& monitor : m_monitors) {
+        if (monitor.activeWorkspaceID == id)
+            monitor.activeWorkspaceID = -1;
+    }
+
+    emit([&](IBackendListener& l) { l.onWorkspaceDestroyed(id); });
+}
+
+void CMockBackend::setFocusedMonitor(MONITORID id) {
+    if (findMonitor(id))
+        m_focusedMonitorID = id;
+}
+
+WINDOWID CMockBackend::openWindow(WORKSPACEID workspaceID) {
+    if (!findWorkspace(workspaceID))
+        return 0;
+
+    const WINDOWID id = m_nextWindowID++;
+    m_windows[id] = SMockWindow{.workspaceID = workspaceID};
+
+    const SWindowState state{.id = id, .workspaceID = workspaceID};
+    emit([&](IBackendListener& l) { l.onWindowOpened(state); });
+
+    return id;
+}
+
+void CMockBackend::closeWindow(WINDOWID id) {
+    auto it = m_windows.find(id);
+    if (it == m_windows.end())
+        return;
+
+    m_windows.erase(it);
+    emit([&](IBackendListener& l) { l.onWindowClosed(id); });
+}
+
+void CMockBackend::moveWindow(WINDOWID id, WORKSPACEID workspaceID) {
+    auto it = m_windows.find(id);
+    if (it == m_windows.end() || !findWorkspace(workspaceID) || it->second.workspaceID == workspaceID)
+        return;
+
+    it->second.workspaceID = workspaceID;
+    emit([&](IBackendListener& l) { l.onWindowMoved(id, workspaceID); });
+}
+
+void CMockBackend::setFullscreen(WINDOWID id, bool fullscreen) {
+    auto it = m_windows.find(id);
+    if (it == m_windows.end())
+        return;
+
+    it->second.fullscreen = fullscreen;
+    emit([&](IBackendListener& l) { l.onWindowFullscreen(id, fullscreen); });
+}
+
+void CMockBackend::setUrgent(WINDOWID id, bool urgent) {
+    auto it = m_windows.find(id);
+    if (it == m_windows.end())
+        return;
+
+    it->second.urgent = urgent;
+    emit([&](IBackendListener& l) { l.onWindowUrgent(id, urgent); });
+}
+
+// State queries
+
+std::vector<SMonitorState> CMockBackend::getMonitors() {
+    return m_monitors;
+}
+
+std::vector<SWorkspaceState> CMockBackend::getWorkspaces() {
+    return m_workspaces;
+}
+
+std::optional<SMonitorState> CMockBackend::getMonitor(MONITORID id) {
+    if (auto* monitor = findMonitor(id))
+        return *monitor;
+    return std::nullopt;
+}
+
+std::optional<SWorkspaceState> CMockBackend::getWorkspace(WORKSPACEID id) {
+    if (auto* workspace = findWorkspace(id))
+        return *workspace;
+    return std::nullopt;
+}
+
+void CMockBackend::forEachMonitor(CFunctionRef<void(const SMonitorView&)> fn) {
+    for (const auto& monitor : m_monitors)
+        fn(toView(monitor));
+}
+
+void CMockBackend::forEachWorkspace(CFunctionRef<void(const SWorkspaceView&)> fn) {
+    for (const auto& workspace : m_workspaces)
+        fn(toView(workspace));
+}
+
+std::optional<SMonitorView> CMockBackend::getMonitorView(MONITORID id) {
+    if (auto* monitor = findMonitor(id))
+        return toView(*monitor);
+    return std::nullopt;
+}
+
+std::optional<SWorkspaceView> CMockBackend::getWorkspaceView(WORKSPACEID id) {
+    if (auto* workspace = findWorkspace(id))
+        return toView(*workspace);
+    return std::nullopt;
+}
+
+std::vector<SWindowState> CMockBackend::getWindows() {
+    std::vector<SWindowState> windows;
+    windows.reserve(m_windows.size());
+    for (const auto& [id, window] : m_windows)
+        windows.push_back({.id = id, .workspaceID = window.workspaceID, .fullscreen = window.fullscreen, .urgent = window.urgent});
+    return windows;
+}
+
+MONITORID CMockBackend::getMonitorIDByName(std::string_view name) {
+    auto it = std::find_if(m_monitors.begin(), m_monitors.end(), [name](const auto& m) { return m.name == name; });
+    return it != m_monitors.end() ? it->id : -1;
+}
+
+MONITORID CMockBackend::getFocusedMonitorID() {
+    return m_focusedMonitorID;
+}
+
+WORKSPACEID CMockBackend::getActiveWorkspaceID(MONITORID monitorID) {
+    auto* monitor = findMonitor(monitorID);
+    return monitor ? monitor->activeWorkspaceID : -1;
+}
+
+std::string CMockBackend::getCurrentLayout() {
+    return "dwindle";
+}
+
+// Mutations
+
+bool CMockBackend::createWorkspace(WORKSPACEID id, MONITORID monitorID, const std::string& name) {
+    if (findWorkspace(id) || !findMonitor(monitorID))
+        return false;
+
+    SWorkspaceState workspace;
+    workspace.id = id;
+    workspace.name = name;
+    workspace.monitorID = monitorID;
+    m_workspaces.push_back(workspace);
+
+    emit([&](IBackendListener& l) { l.onWorkspaceCreated(workspace); });
+    return true;
+}
+
+bool CMockBackend::changeWorkspace(MONITORID monitorID, WORKSPACEID id) {
+    auto* monitor = findMonitor(monitorID);
+    auto* workspace = findWorkspace(id);
+    if (!monitor || !workspace)
+        return false;
+
+    if (workspace->monitorID != monitorID && !moveWorkspaceToMonitor(id, monitorID))
+        return false;
+
+    monitor = findMonitor(monitorID);
+    monitor->activeWorkspaceID = id;
+
+    emit([&](IBackendListener& l) { l.onWorkspaceActivated(monitorID, id); });
+    return true;
+}
+
+bool CMockBackend::changeWorkspaces(std::span<const SWorkspaceAssignment> assignments, bool) {
+    for (const auto& assignment : assignments) {
+        if (!findMonitor(assignment.monitorID) || !findWorkspace(assignment.workspaceID))
+            return false;
+    }
+
+    for (const auto& assignment : assignments) {
+        if (findWorkspace(assignment.workspaceID)->monitorID != assignment.monitorID)
+            moveWorkspaceToMonitor(assignment.workspaceID, assignment.monitorID);
+        findMonitor(assignment.monitorID)->activeWorkspaceID = assignment.workspaceID;
+    }
+
+    // Announce only once the whole set is applied
+    for (const auto& assignment : assignments)
+        emit([&](IBackendListener& l) { l.onWorkspaceActivated(assignment.monitorID, assignment.workspaceID); });
+
+    return true;
+}
+
+bool CMockBackend::moveWorkspaceToMonitor(WORKSPACEID id, MONITORID monitorID) {
+    auto* workspace = findWorkspace(id);
+    auto* target = findMonitor(monitorID);
+    if (!workspace || !target)
+        return false;
+
+    const MONITORID sourceID = workspace->monitorID;
+    if (sourceID == monitorID)
+        return true;
+
+    workspace->monitorID = monitorID;
+    if (target->activeWorkspaceID == -1)
+        target->activeWorkspaceID = id;
+
+    // The source monitor must keep showing something: fall back to another
+    // workspace it owns, or create a fresh one like Hyprland does
+    if (auto* source = findMonitor(sourceID); source && source->activeWorkspaceID == id) {
+        auto fallback = std::find_if(m_workspaces.begin(), m_workspaces.end(),
+                                     [sourceID](const auto& w) { return w.monitorID == sourceID; });
+        if (fallback != m_workspaces.end()) {
+            source->activeWorkspaceID = fallback->id;
+        } else {
+            const WORKSPACEID fallbackID = nextFreeWorkspaceID();
+            createWorkspace(fallbackID, sourceID, std::to_string(fallbackID));
+            findMonitor(sourceID)->activeWorkspaceID = fallbackID;
+        }
+    }
+
+    emit([&](IBackendListener& l) { l.onWorkspaceMoved(id, monitorID); });
+    return true;
+}
+
+bool CMockBackend::renameWorkspace(WORKSPACEID id, const std::string& name) {
+    auto* workspace = findWorkspace(id);
+    if (!workspace)
+        return false;
+
+    workspace->name = name;
+    return true;
+}
+
+void CMockBackend::releaseWorkspaces(std::span<const WORKSPACEID> ids) {
+    for (const WORKSPACEID id : ids) {
+        if (!findWorkspace(id))
+            continue;
+
+        const bool shown = std::any_of(m_monitors.begin(), m_monitors.end(),
+                                       [id](const auto& monitor) { return monitor.activeWorkspaceID == id; });
+        const bool occupied = std::any_of(m_windows.begin(), m_windows.end(),
+                                          [id](const auto& window) { return window.second.workspaceID == id; });
+        if (shown || occupied)
+            continue;
+
+        std::erase_if(m_workspaces, [id](const auto& w) { return w.id == id; });
+        emit([&](IBackendListener& l) { l.onWorkspaceDestroyed(id); });
+    }
+}
+
+void CMockBackend::notify(const std::string& /*message*/, eNotifyLevel /*level*/, int /*durationMs*/) {
+    ++m_notificationCount;
+}
+
+} // namespace VDM
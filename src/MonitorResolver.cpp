@@ -0,0 +1,62 @@
+#include "MonitorResolver.hpp"
+
+#include <algorithm>
+#include <charconv>
+
+namespace VDM {
+
+    MONITORID CMonitorResolver::resolve(std::string_view selector) const {
+        if (selector.empty())
+            return -1;
+
+        if (auto it = m_byName.find(selector); it != m_byName.end())
+            return it->second;
+
+        MONITORID id = -1;
+        const auto [end, ec] = std::from_chars(selector.data(), selector.data() + selector.size(), id);
+        if (ec == std::errc() && end == selector.data() + selector.size()) {
+            // A handful of monitors at most: a scan beats hashing here
+            auto it = std::find_if(m_monitors.begin(), m_monitors.end(), [id](const auto& m) { return m.id == id; });
+            return it != m_monitors.end() ? it->id : -1;
+        }
+
+        if (selector.starts_with(DESCRIPTION_PREFIX)) {
+            const auto needle = selector.substr(DESCRIPTION_PREFIX.size());
+            auto it = std::find_if(m_monitors.begin(), m_monitors.end(),
+                                   [needle](const auto& m) { return m.description.find(needle) != std::string::npos; });
+            return it != m_monitors.end() ? it->id : -1;
+        }
+
+        return -1;
+    }
+
+    void CMonitorResolver::addMonitor(const SMonitorState& monitor) {
+        auto it = std::find_if(m_monitors.begin(), m_monitors.end(), [&monitor](const auto& m) { return m.id == monitor.id; });
+        if (it != m_monitors.end()) {
+            it->name = monitor.name;
+            it->description = monitor.description;
+        } else
+            m_monitors.push_back({.id = monitor.id, .name = monitor.name, .description = monitor.description});
+
+        rebuildNameTable();
+    }
+
+    void CMonitorResolver::removeMonitor(const MONITORID id) {
+        if (std::erase_if(m_monitors, [id](const auto& m) { return m.id == id; }) > 0)
+            rebuildNameTable();
+    }
+
+    void CMonitorResolver::clear() {
+        m_monitors.clear();
+        m_byName.clear();
+    }
+
+    void CMonitorResolver::rebuildNameTable() {
+        // Adding or removing an entry may move the strings the views point to
+        m_byName.clear();
+        m_byName.reserve(m_monitors.size());
+        for (const auto& monitor : m_monitors)
+            m_byName.emplace(monitor.name, monitor.id);
+    }
+
+} // namespace VDM
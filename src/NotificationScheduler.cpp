@@ -0,0 +1,93 @@
+#include "NotificationScheduler.hpp"
+
+#include <algorithm>
+
+namespace VDM {
+
+void CNotificationScheduler::setBackend(ICompositorBackend* backend) {
+    m_pBackend = backend;
+    m_bursts.clear();
+}
+
+bool CNotificationScheduler::isEnabled(eNotifyLevel level) const {
+    switch (m_verbosity) {
+        case NOTIFY_VERBOSITY_OFF:      return false;
+        case NOTIFY_VERBOSITY_ERRORS:   return level == NOTIFY_ERROR;
+        case NOTIFY_VERBOSITY_WARNINGS: return level != NOTIFY_OK;
+        case NOTIFY_VERBOSITY_ALL:      return true;
+    }
+    return true;
+}
+
+bool CNotificationScheduler::admit(const SNotifyTopic& topic, eNotifyLevel level) {
+    const auto now = Clock::now();
+    auto [it, inserted] = m_bursts.try_emplace(topic.key);
+    auto& burst = it->second;
+
+    if (!inserted && now < burst.windowEnd) {
+        burst.level = std::max(burst.level, level);
+        if (burst.merged++ == 0)
+            armTimer(now);
+        ++m_mergedCount;
+        return false;
+    }
+
+    // No burst, or the last one is over: close it and open a new window
+    if (!inserted && burst.merged > 0)
+        postSummary(burst);
+
+    burst = {.topic = &topic, .windowEnd = now + m_window, .level = level, .merged = 0};
+    return true;
+}
+
+void CNotificationScheduler::postSummary(const SBurst& burst) {
+    if (!m_pBackend || !isEnabled(burst.level))
+        return;
+
+    // The notification shown when the window opened counts too
+    const uint32_t total = burst.merged + 1;
+    m_pBackend->notify(std::vformat(burst.topic->summary, std::make_format_args(total)), burst.level,
+                       burst.topic->durationMs);
+}
+
+void CNotificationScheduler::armTimer(Clock::time_point now) {
+    if (!m_timerCallback)
+        return;
+
+    Clock::time_point next = Clock::time_point::max();
+    for (const auto& [key, burst] : m_bursts) {
+        if (burst.merged > 0)
+            next = std::min(next, burst.windowEnd);
+    }
+    if (next == Clock::time_point::max())
+        return;
+
+    const auto delay = std::chrono::ceil<std::chrono::milliseconds>(next - now).count();
+    m_timerCallback(static_cast<int>(std::max<int64_t>(delay, 1)));
+}
+
+void CNotificationScheduler::dispatch() {
+    const auto now = Clock::now();
+
+    for (auto it = m_bursts.begin(); it != m_bursts.end();) {
+        if (now < it->second.windowEnd) {
+            ++it;
+            continue;
+        }
+        if (it->second.merged > 0)
+            postSummary(it->second);
+        it = m_bursts.erase(it);
+    }
+
+    armTimer(now);
+}
+
+void CNotificationScheduler::flush() {
+    for (const auto& [key, burst] : m_bursts) {
+        if (burst.merged > 0)
+            postSummary(burst);
+    }
+    m_bursts.clear();
+}
+
+} // namespace VDM
@@ -0,0 +1,41 @@
+#include "RequestArena.hpp"
+
+namespace VDM {
+
+namespace {
+
+    // Blocks up to this size are kept for the next request instead of being
+    // returned to the heap
+    constexpr size_t MAX_POOLED_BLOCK = 1024 * 1024;
+
+    struct SArena {
+        alignas(std::max_align_t) std::byte buffer[CRequestArena::INLINE_SIZE];
+        std::pmr::unsynchronized_pool_resource blocks{{.max_blocks_per_chunk = 4, .largest_required_pool_block = MAX_POOLED_BLOCK},
+                                                      std::pmr::new_delete_resource()};
+        std::pmr::monotonic_buffer_resource resource{buffer, sizeof(buffer), &blocks};
+        int depth = 0;
+    };
+
+    SArena& getArena() {
+        thread_local SArena arena;
+        return arena;
+    }
+
+} // namespace
+
+CRequestArena::CScope::CScope() {
+    ++getArena().depth;
+}
+
+CRequestArena::CScope::~CScope() {
+    auto& arena = getArena();
+    if (--arena.depth == 0)
+        arena.resource.release();
+}
+
+std::pmr::memory_resource* CRequestArena::getResource() {
+    auto& arena = getArena();
+    return arena.depth > 0 ? &arena.resource : std::pmr::get_default_resource();
+}
+
+} // namespace VDM
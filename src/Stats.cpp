@@ -0,0 +1,188 @@
+#include "Stats.hpp"
+
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <iterator>
+
+namespace VDM {
+
+namespace {
+
+    // Log-linear buckets: values below SUB_BUCKETS get one bucket each, every
+    // power of two above is split in SUB_BUCKETS, up to 2^MAX_BITS ns (about
+    // 18 minutes). One last bucket takes everything longer
+    constexpr uint32_t SUB_BITS = 3;
+    constexpr uint64_t SUB_BUCKETS = 1ull << SUB_BITS;
+    constexpr uint32_t MAX_BITS = 40;
+    constexpr size_t OVERFLOW_BUCKET = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+    constexpr size_t BUCKET_COUNT = OVERFLOW_BUCKET + 1;
+
+    constexpr std::string_view NAMES[STAT_COUNT] = {
+        "dispatch.vdesk",
+
+        "command.info",
+        "command.list",
+        "command.stats",
+        "command.trace",
+
+        "event.monitorAdded",
+        "event.monitorRemoved",
+        "event.workspaceCreated",
+        "event.workspaceDestroyed",
+        "event.workspaceMoved",
+        "event.workspaceActivated",
+        "event.windowOpened",
+        "event.windowClosed",
+        "event.windowMoved",
+        "event.windowFullscreen",
+        "event.windowUrgent",
+        "event.windowActivated",
+
+        "workspace.create",
+        "workspace.delete",
+        "workspace.switch",
+        "workspace.move",
+        "workspace.rename",
+        "workspace.reclaim",
+        "query.workspaces",
+        "query.monitors",
+
+        "desktop.switch",
+    };
+    static_assert(!NAMES[STAT_COUNT - 1].empty(), "every eStatOp needs a name");
+
+    struct SOpStats {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> totalNs{0};
+        std::atomic<uint64_t> maxNs{0};
+        std::atomic<uint64_t> allocs{0};
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+    };
+
+    std::array<SOpStats, STAT_COUNT> gStats;
+    std::atomic<Stats::AllocationCounter> gAllocationCounter{nullptr};
+
+    constexpr size_t bucketIndex(uint64_t ns) {
+        if (ns < SUB_BUCKETS)
+            return ns;
+
+        const uint32_t exponent = std::bit_width(ns) - 1;
+        if (exponent >= MAX_BITS)
+            return OVERFLOW_BUCKET;
+
+        const uint32_t shift = exponent - SUB_BITS;
+        return ((exponent - SUB_BITS + 1) << SUB_BITS) + ((ns >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    // Largest value that lands in a bucket
+    constexpr uint64_t bucketUpperBound(size_t index) {
+        if (index < SUB_BUCKETS)
+            return index;
+        if (index >= OVERFLOW_BUCKET)
+            return UINT64_MAX;
+
+        const uint32_t shift = (index >> SUB_BITS) - 1;
+        const uint64_t lower = (SUB_BUCKETS + (index & (SUB_BUCKETS - 1))) << shift;
+        return lower + (1ull << shift) - 1;
+    }
+
+    static_assert(bucketIndex((1ull << MAX_BITS) - 1) == OVERFLOW_BUCKET - 1, "buckets end below 2^MAX_BITS");
+    static_assert(bucketUpperBound(OVERFLOW_BUCKET - 1) == (1ull << MAX_BITS) - 1, "bucket bounds match bucketIndex");
+    static_assert(bucketIndex(1ull << MAX_BITS) == OVERFLOW_BUCKET && OVERFLOW_BUCKET < BUCKET_COUNT);
+
+} // namespace
+
+namespace Stats {
+
+    void setAllocationCounter(AllocationCounter counter) {
+        gAllocationCounter.store(counter, std::memory_order_relaxed);
+    }
+
+    bool isCountingAllocations() {
+        return gAllocationCounter.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    uint64_t getAllocationCount() {
+        const auto counter = gAllocationCounter.load(std::memory_order_relaxed);
+        return counter ? counter() : 0;
+    }
+
+    std::string_view getName(eStatOp op) {
+        return op < STAT_COUNT ? NAMES[op] : "unknown";
+    }
+
+    void record(eStatOp op, std::chrono::nanoseconds duration, uint64_t allocs) {
+        if (op >= STAT_COUNT)
+            return;
+
+        auto& stats = gStats[op];
+        const uint64_t ns = duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+
+        stats.count.fetch_add(1, std::memory_order_relaxed);
+        stats.totalNs.fetch_add(ns, std::memory_order_relaxed);
+        stats.buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        if (allocs)
+            stats.allocs.fetch_add(allocs, std::memory_order_relaxed);
+
+        uint64_t max = stats.maxNs.load(std::memory_order_relaxed);
+        while (ns > max && !stats.maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    SStatSummary getSummary(eStatOp op) {
+        SStatSummary summary;
+        summary.name = getName(op);
+        if (op >= STAT_COUNT)
+            return summary;
+
+        const auto& stats = gStats[op];
+
+        // Take the bucket counts once; the total comes from them so that
+        // percentiles stay consistent with concurrent recording
+        std::array<uint64_t, BUCKET_COUNT> buckets;
+        uint64_t total = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            buckets[i] = stats.buckets[i].load(std::memory_order_relaxed);
+            total += buckets[i];
+        }
+
+        summary.count = total;
+        summary.maxNs = stats.maxNs.load(std::memory_order_relaxed);
+        summary.allocs = stats.allocs.load(std::memory_order_relaxed);
+        if (total == 0)
+            return summary;
+
+        summary.meanNs = stats.totalNs.load(std::memory_order_relaxed) / total;
+
+        const uint64_t ranks[] = {(total * 50 + 99) / 100, (total * 90 + 99) / 100, (total * 99 + 99) / 100};
+        uint64_t* targets[] = {&summary.p50Ns, &summary.p90Ns, &summary.p99Ns};
+
+        uint64_t seen = 0;
+        size_t next = 0;
+        for (size_t i = 0; i < BUCKET_COUNT && next < std::size(ranks); ++i) {
+            seen += buckets[i];
+            // The last bucket is open-ended: only the max bounds it
+            const uint64_t bound = std::min(bucketUpperBound(i), summary.maxNs);
+            while (next < std::size(ranks) && seen >= ranks[next])
+                *targets[next++] = bound;
+        }
+
+        return summary;
+    }
+
+    void reset() {
+        for (auto& stats : gStats) {
+            stats.count.store(0, std::memory_order_relaxed);
+            stats.totalNs.store(0, std::memory_order_relaxed);
+            stats.maxNs.store(0, std::memory_order_relaxed);
+            stats.allocs.store(0, std::memory_order_relaxed);
+            for (auto& bucket : stats.buckets)
+                bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+} // namespace Stats
+
+} // namespace VDM
@@ -0,0 +1,123 @@
+#include "Trace.hpp"
+#include "RequestArena.hpp"
+#include "Serializer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+
+namespace VDM::Trace {
+
+    namespace {
+
+        struct SEvent {
+            std::string_view name;
+            int64_t beginNs = 0;
+            int64_t durationNs = 0;
+        };
+
+        /**
+         * Ring buffer of one thread; only that thread writes to it
+         */
+        struct SThreadBuffer {
+            pid_t tid = 0;
+            std::atomic<uint64_t> written{0};
+            std::unique_ptr<SEvent[]> events = std::make_unique<SEvent[]>(BUFFER_EVENTS);
+        };
+
+        // Buffers are registered on a thread's first event and kept until
+        // unload, so a dump still sees threads that have exited
+        std::mutex gBuffersMutex;
+        std::vector<std::unique_ptr<SThreadBuffer>> gBuffers;
+        std::atomic<int64_t> gOriginNs{0};
+
+        thread_local SThreadBuffer* tBuffer = nullptr;
+
+        int64_t toNs(Clock::time_point time) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+        }
+
+        SThreadBuffer* registerThread() {
+            auto buffer = std::make_unique<SThreadBuffer>();
+            buffer->tid = gettid();
+
+            std::lock_guard lock(gBuffersMutex);
+            return gBuffers.emplace_back(std::move(buffer)).get();
+        }
+
+    } // namespace
+
+    void start() {
+        std::lock_guard lock(gBuffersMutex);
+        for (auto& buffer : gBuffers)
+            buffer->written.store(0, std::memory_order_relaxed);
+        gOriginNs.store(toNs(Clock::now()), std::memory_order_relaxed);
+        gEnabled.store(true, std::memory_order_release);
+    }
+
+    void stop() {
+        gEnabled.store(false, std::memory_order_release);
+    }
+
+    void record(std::string_view name, Clock::time_point begin, Clock::time_point end) {
+        if (!tBuffer)
+            tBuffer = registerThread();
+
+        const uint64_t index = tBuffer->written.load(std::memory_order_relaxed);
+        tBuffer->events[index % BUFFER_EVENTS] = {.name = name, .beginNs = toNs(begin), .durationNs = toNs(end) - toNs(begin)};
+        tBuffer->written.store(index + 1, std::memory_order_release);
+    }
+
+    bool write(std::string_view path, size_t& events) {
+        events = 0;
+
+        const pid_t pid = getpid();
+        const int64_t origin = gOriginNs.load(std::memory_order_relaxed);
+
+        std::pmr::string json(CRequestArena::getResource());
+        CSerializer out(json, eHyprCtlOutputFormat::FORMAT_JSON);
+        out.beginObject();
+        out.field("displayTimeUnit", "ns");
+        out.beginArray("traceEvents");
+        {
+            std::lock_guard lock(gBuffersMutex);
+            json.reserve(gBuffers.size() * 128);
+
+            for (const auto& buffer : gBuffers) {
+                // Oldest first; wrapped buffers start past the overwritten events
+                const uint64_t written = buffer->written.load(std::memory_order_acquire);
+                const uint64_t first = written - std::min<uint64_t>(written, BUFFER_EVENTS);
+
+                for (uint64_t i = first; i < written; ++i) {
+                    const SEvent& event = buffer->events[i % BUFFER_EVENTS];
+                    out.beginObject();
+                    out.field("name", event.name);
+                    out.field("cat", "vdm");
+                    out.field("ph", "X");
+                    // Chrome trace timestamps are in microseconds
+                    out.field("ts", static_cast<double>(event.beginNs - origin) / 1000.0);
+                    out.field("dur", static_cast<double>(event.durationNs) / 1000.0);
+                    out.field("pid", pid);
+                    out.field("tid", buffer->tid);
+                    out.endObject();
+                }
+                events += written - first;
+            }
+        }
+        out.endArray();
+        out.endObject();
+
+        const std::pmr::string fileName(path, CRequestArena::getResource());
+        FILE* file = std::fopen(fileName.c_str(), "w");
+        if (!file)
+            return false;
+
+        const bool written = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+        return std::fclose(file) == 0 && written;
+    }
+
+} // namespace VDM::Trace
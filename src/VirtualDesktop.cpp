@@ -1,6 +1,7 @@
 #include "VirtualDesktop.hpp"
 
-#include <sstream>
+#include <format>
+#include <iterator>
 
 namespace VDM {
 
@@ -12,24 +13,23 @@ namespace VDM {
     CVirtualDesktop::~CVirtualDesktop() = default;
 
     const std::string CVirtualDesktop::toString() const {
-        std::ostringstream ss;
-        ss << "VirtualDesktop{id=" << m_id << ", name='" << m_name << "', active=" << std::boolalpha << m_isActive << '}';
-        return ss.str();
+        std::string out;
+        out.reserve(48 + m_name.size());
+        std::format_to(std::back_inserter(out), "VirtualDesktop{{id={}, name='{}', active={}}}", m_id, m_name, m_isActive);
+        return out;
     }
 
     const std::string CVirtualDesktop::toStringDetailed() const {
-        std::ostringstream ss;
-        ss << "VirtualDesktop{id=" << m_id << ", name='" << m_name << "', active=" << std::boolalpha << m_isActive
-        << ", workspaces=[";
-
-        for (size_t i = 0; i < m_workspaceIds.size(); ++i) {
-            ss << m_workspaceIds[i];
-            if (i + 1 < m_workspaceIds.size())
-                ss << ", ";
-        }
-
-        ss << "]}";
-        return ss.str();
+        std::string out;
+        out.reserve(64 + m_name.size() + m_workspaceIds.size() * 8);
+        std::format_to(std::back_inserter(out), "VirtualDesktop{{id={}, name='{}', active={}, workspaces=[", m_id, m_name,
+                       m_isActive);
+
+        for (size_t i = 0; i < m_workspaceIds.size(); ++i)
+            std::format_to(std::back_inserter(out), "{}{}", i ? ", " : "", m_workspaceIds[i]);
+
+        out.append("]}");
+        return out;
     }
 
 } // namespace VDM
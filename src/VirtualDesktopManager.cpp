@@ -1,8 +1,15 @@
 #include "VirtualDesktopManager.hpp"
+#include "workspace_manager.hpp"
+#include "LoggerFacade.hpp"
+#include "Stats.hpp"
+#include "globals.hpp"
+
+#include <algorithm>
+#include <format>
 
 namespace VDM {
 
-CVirtualDesktopManager& CVirtualDesktopManager::instance() {
+CVirtualDesktopManager& CVirtualDesktopManager::getInstance() {
     static CVirtualDesktopManager s_instance;
     return s_instance;
 }
@@ -10,4 +17,401 @@ CVirtualDesktopManager& CVirtualDesktopManager::instance() {
 CVirtualDesktopManager::CVirtualDesktopManager() = default;
 CVirtualDesktopManager::~CVirtualDesktopManager() = default;
 
-} // namespace VDM
\ No newline at end of file
+void CVirtualDesktopManager::initialize(ICompositorBackend* backend) {
+    shutdown();
+
+    m_pBackend = backend;
+    if (!m_pBackend)
+        return;
+
+    m_pBackend->addListener(this);
+    m_reclaimer.setBackend(m_pBackend);
+    markChanged();
+
+    // Desktop 1 is whatever is on screen right now
+    auto& desktop = m_layout.createDesktop();
+    for (const auto& monitor : m_pBackend->getMonitors()) {
+        const size_t slot = m_layout.attachMonitor(monitor.id, monitor.name);
+        if (monitor.activeWorkspaceID != -1)
+            m_layout.setWorkspaceID(desktop.getID(), slot, monitor.activeWorkspaceID);
+    }
+    reserveWorkspaces(desktop);
+    m_layout.setActiveDesktopID(desktop.getID());
+
+    CWorkspaceManager::getInstance()->setOccupancyCallback([this](WORKSPACEID id) { refreshOccupancy(id); });
+    CWorkspaceManager::getInstance()->setCountersCallback([this](WORKSPACEID id) { onCountersChanged(id); });
+    CWorkspaceManager::getInstance()->setReservedWorkspaceIDs(MAX_DESKTOPS * WORKSPACES_PER_DESKTOP);
+    refreshOccupancy(-1);
+}
+
+void CVirtualDesktopManager::shutdown() {
+    if (m_pBackend) {
+        m_pBackend->removeListener(this);
+        CWorkspaceManager::getInstance()->setOccupancyCallback(nullptr);
+        CWorkspaceManager::getInstance()->setCountersCallback(nullptr);
+        CWorkspaceManager::getInstance()->setReservedWorkspaceIDs(0);
+    }
+
+    m_pBackend = nullptr;
+    m_reclaimer.setBackend(nullptr);
+    m_layout = CLayout();
+    markChanged();
+    m_lastSwitch = {};
+    m_pendingSwitch = -1;
+    m_changedDesktops.clear();
+    m_publishedCounters.clear();
+}
+
+void CVirtualDesktopManager::setEventServer(CEventServer* server) {
+    m_pEventServer = server;
+    m_publishedCounters.clear();
+}
+
+bool CVirtualDesktopManager::isWorkspaceIDFree(const WORKSPACEID id) {
+    return !m_layout.findWorkspace(id) && !CWorkspaceManager::getInstance()->workspaceExists(id);
+}
+
+WORKSPACEID CVirtualDesktopManager::reserveWorkspaceID(const CVirtualDesktop& desktop, const size_t slot) {
+    const WORKSPACEID rangeFirst = static_cast<WORKSPACEID>(desktop.getID() - 1) * WORKSPACES_PER_DESKTOP + 1;
+    const WORKSPACEID rangeLast = rangeFirst + WORKSPACES_PER_DESKTOP - 1;
+    for (WORKSPACEID id = rangeFirst + static_cast<WORKSPACEID>(slot); id <= rangeLast; ++id) {
+        if (isWorkspaceIDFree(id))
+            return id;
+    }
+
+    // Range full: the workspace gets an ID past all desktop ranges when it is first shown
+    return -1;
+}
+
+void CVirtualDesktopManager::reserveWorkspaces(const CVirtualDesktop& desktop) {
+    for (size_t slot = 0; slot < m_layout.getSlotCount(); ++slot) {
+        if (desktop.getWorkspaceID(slot) != -1)
+            continue;
+
+        if (const WORKSPACEID id = reserveWorkspaceID(desktop, slot); id != -1)
+            m_layout.setWorkspaceID(desktop.getID(), slot, id);
+    }
+}
+
+WORKSPACEID CVirtualDesktopManager::ensureWorkspace(const CVirtualDesktop& desktop, const size_t slot) {
+    const MONITORID monitorID = m_layout.getSlotMonitor(slot);
+
+    WORKSPACEID id = desktop.getWorkspaceID(slot);
+    if (id != -1 && m_pBackend->getWorkspaceView(id))
+        return id;
+
+    if (id == -1) {
+        id = reserveWorkspaceID(desktop, slot);
+
+        // Past every desktop's range, and never an ID another desktop has
+        // reserved but not created yet: assigning it here would take it away
+        for (WORKSPACEID overflow = MAX_DESKTOPS * WORKSPACES_PER_DESKTOP + 1; id == -1; ++overflow) {
+            if (isWorkspaceIDFree(overflow))
+                id = overflow;
+        }
+        m_layout.setWorkspaceID(desktop.getID(), slot, id);
+    }
+
+    // Materialize the reserved workspace. Created directly on the backend: a
+    // desktop switch should not raise one "workspace created" notification per monitor
+    if (!m_pBackend->createWorkspace(id, monitorID, std::to_string(id)))
+        return -1;
+
+    return id;
+}
+
+void CVirtualDesktopManager::scheduleRelease(const CVirtualDesktop& desktop) {
+    // The IDs stay reserved in the layout, so the desktop gets the same
+    // workspaces back when it is shown again. The reclaimer checks whether a
+    // workspace is empty and hidden when its grace period is over.
+    for (const WORKSPACEID id : desktop.getWorkspaceIDs()) {
+        if (id != -1 && m_pBackend->getWorkspaceView(id))
+            m_reclaimer.schedule(id);
+    }
+}
+
+SSwitchResult CVirtualDesktopManager::switchToDesktop(const int id, const bool animate) {
+    VDM_STAT_SCOPE(STAT_DESKTOP_SWITCH);
+
+    const auto start = std::chrono::steady_clock::now();
+    SSwitchResult result;
+
+    // A direct switch supersedes a deferred one
+    m_pendingSwitch = -1;
+
+    if (!m_pBackend || id < 1 || id > MAX_DESKTOPS)
+        return m_lastSwitch = result;
+
+    while (m_layout.getDesktopCount() < static_cast<size_t>(id)) {
+        const auto& created = m_layout.createDesktop();
+        reserveWorkspaces(created);
+        markChanged();
+        if (m_pEventServer)
+            m_pEventServer->publish("vdeskcreated", std::format("{},{}", created.getID(), created.getName()));
+    }
+
+    auto* desktop = m_layout.findDesktop(id);
+    if (!desktop)
+        return m_lastSwitch = result;
+
+    m_assignments.clear();
+    for (size_t slot = 0; slot < m_layout.getSlotCount(); ++slot) {
+        const MONITORID monitorID = m_layout.getSlotMonitor(slot);
+        if (monitorID == -1)
+            continue;
+
+        const WORKSPACEID workspaceID = ensureWorkspace(*desktop, slot);
+        if (workspaceID == -1) {
+            CWorkspaceManager::getInstance()->getNotifications().post(NotifyTopics::DESKTOP_FAILED, NOTIFY_ERROR,
+                                                                      "[VDM] Failed to prepare desktop {}", id);
+            return m_lastSwitch = result;
+        }
+        m_reclaimer.cancel(workspaceID);
+
+        if (m_pBackend->getActiveWorkspaceID(monitorID) != workspaceID)
+            m_assignments.push_back({.monitorID = monitorID, .workspaceID = workspaceID});
+    }
+
+    if (!m_assignments.empty() && !m_pBackend->changeWorkspaces(m_assignments, animate)) {
+        CWorkspaceManager::getInstance()->getNotifications().post(NotifyTopics::DESKTOP_FAILED, NOTIFY_ERROR,
+                                                                  "[VDM] Failed to switch to desktop {}", id);
+        return m_lastSwitch = result;
+    }
+
+    const int previousID = m_layout.getActiveDesktopID();
+    const bool changed = previousID != id;
+    m_layout.setActiveDesktopID(id);
+    if (changed) {
+        markChanged();
+        if (m_pEventServer)
+            m_pEventServer->publish("vdesk", std::to_string(id));
+
+        if (const auto* previous = m_layout.findDesktop(previousID))
+            scheduleRelease(*previous);
+    }
+
+    result.success = true;
+    result.monitorsChanged = m_assignments.size();
+    result.duration = std::chrono::steady_clock::now() - start;
+    m_lastSwitchTime = start;
+    if (!animate && !m_assignments.empty())
+        ++m_instantSwitchCount;
+
+    AppLog::trace(AppLog::Category::VDesk, "Switched to desktop {} ({} monitors) in {}us", id, result.monitorsChanged,
+                  std::chrono::duration_cast<std::chrono::microseconds>(result.duration).count());
+
+    return m_lastSwitch = result;
+}
+
+bool CVirtualDesktopManager::requestSwitch(const int id) {
+    if (id < 1 || id > MAX_DESKTOPS)
+        return false;
+
+    const auto now = std::chrono::steady_clock::now();
+    ++m_switchRequestCount;
+
+    const bool rapid = m_instantThreshold.count() > 0 && now - m_lastRequestTime < m_instantThreshold;
+    m_lastRequestTime = now;
+
+    if (m_pendingSwitch != -1) {
+        m_pendingSwitch = id;
+        m_pendingAnimate = !rapid;
+        ++m_coalescedCount;
+        return true;
+    }
+
+    const auto nextSwitch = m_lastSwitchTime + m_frameInterval;
+    if (!m_switchTimerCallback || now >= nextSwitch)
+        return switchToDesktop(id, !rapid).success;
+
+    m_pendingSwitch = id;
+    m_pendingAnimate = !rapid;
+    const auto delay = std::chrono::ceil<std::chrono::milliseconds>(nextSwitch - now).count();
+    m_switchTimerCallback(static_cast<int>(std::max<int64_t>(delay, 1)));
+    return true;
+}
+
+void CVirtualDesktopManager::flushSwitch() {
+    if (m_pendingSwitch == -1)
+        return;
+
+    switchToDesktop(m_pendingSwitch, m_pendingAnimate);
+}
+
+std::optional<int> CVirtualDesktopManager::findOccupiedDesktop(const int from, const bool forward) const {
+    const auto& desktops = m_layout.getDesktops();
+    const auto* desktop = m_layout.findDesktop(from);
+    const size_t index = desktop ? static_cast<size_t>(desktop - desktops.data()) : 0;
+
+    const auto& occupied = m_layout.getOccupied();
+    const auto found = forward ? occupied.findNext(index) : occupied.findPrev(index);
+    if (!found)
+        return std::nullopt;
+    return desktops[*found].getID();
+}
+
+void CVirtualDesktopManager::refreshOccupancy(const WORKSPACEID id) {
+    const auto* workspaces = CWorkspaceManager::getInstance();
+
+    if (id != -1) {
+        if (const auto cell = m_layout.findWorkspace(id))
+            m_layout.setOccupied(*cell, workspaces->getWindowCounters(id).windows > 0);
+        return;
+    }
+
+    const auto& desktops = m_layout.getDesktops();
+    for (uint32_t desktop = 0; desktop < desktops.size(); ++desktop) {
+        for (uint32_t slot = 0; slot < m_layout.getSlotCount(); ++slot) {
+            const WORKSPACEID workspaceID = desktops[desktop].getWorkspaceID(slot);
+            m_layout.setOccupied({.desktop = desktop, .slot = slot},
+                                 workspaceID != -1 && workspaces->getWindowCounters(workspaceID).windows > 0);
+        }
+    }
+}
+
+SWindowCounters CVirtualDesktopManager::getWindowCounters(const int id) {
+    SWindowCounters counters;
+
+    const auto* desktop = m_layout.findDesktop(id);
+    if (!desktop)
+        return counters;
+
+    const auto* workspaces = CWorkspaceManager::getInstance();
+    for (const WORKSPACEID workspaceID : desktop->getWorkspaceIDs()) {
+        if (workspaceID != -1)
+            counters += workspaces->getWindowCounters(workspaceID);
+    }
+
+    return counters;
+}
+
+bool CVirtualDesktopManager::renameDesktop(const int id, std::string_view name) {
+    auto* desktop = m_layout.findDesktop(id);
+    if (!desktop)
+        return false;
+
+    desktop->setName(name);
+    markChanged();
+    if (m_pEventServer)
+        m_pEventServer->publish("vdeskrenamed", std::format("{},{}", id, desktop->getName()));
+
+    return true;
+}
+
+void CVirtualDesktopManager::onCountersChanged(const WORKSPACEID id) {
+    if (id == -1) {
+        markChanged();
+        m_changedDesktops.clear();
+        for (uint32_t desktop = 0; desktop < m_layout.getDesktopCount(); ++desktop)
+            m_changedDesktops.push_back(desktop);
+        return;
+    }
+
+    // A listing shows per-monitor counters too, so any change in a cell shows
+    const auto cell = m_layout.findWorkspace(id);
+    if (!cell)
+        return;
+
+    markChanged();
+    if (std::ranges::find(m_changedDesktops, cell->desktop) == m_changedDesktops.end())
+        m_changedDesktops.push_back(cell->desktop);
+}
+
+void CVirtualDesktopManager::publishWindowCounters() {
+    if (m_changedDesktops.empty())
+        return;
+
+    const auto& desktops = m_layout.getDesktops();
+    if (m_pEventServer) {
+        m_publishedCounters.resize(desktops.size());
+        for (const uint32_t index : m_changedDesktops) {
+            if (index >= desktops.size())
+                continue;
+
+            // A window moved between two monitors of one desktop leaves its sum alone
+            const int id = desktops[index].getID();
+            const SWindowCounters counters = getWindowCounters(id);
+            if (counters == m_publishedCounters[index])
+                continue;
+
+            m_publishedCounters[index] = counters;
+            m_pEventServer->publish("vdeskwindows", std::format("{},{},{},{}", id, counters.windows,
+                                                                counters.fullscreen, counters.urgent));
+        }
+    }
+
+    m_changedDesktops.clear();
+}
+
+void CVirtualDesktopManager::onMonitorAdded(const SMonitorState& monitor) {
+    markChanged();
+
+    const size_t slot = m_layout.attachMonitor(monitor.id, monitor.name);
+
+    // A brand-new slot shows its first workspace on the active desktop
+    if (auto* desktop = m_layout.getActiveDesktop(); desktop && desktop->getWorkspaceID(slot) == -1 && monitor.activeWorkspaceID != -1)
+        m_layout.setWorkspaceID(desktop->getID(), slot, monitor.activeWorkspaceID);
+
+    // and has an ID reserved on every other desktop
+    for (const auto& desktop : m_layout.getDesktops())
+        reserveWorkspaces(desktop);
+
+    refreshOccupancy(-1);
+}
+
+void CVirtualDesktopManager::onMonitorRemoved(MONITORID id) {
+    markChanged();
+
+    m_layout.detachMonitor(id);
+}
+
+void CVirtualDesktopManager::markChangedIfOwned(const WORKSPACEID id) {
+    if (m_layout.findWorkspace(id))
+        markChanged();
+}
+
+void CVirtualDesktopManager::onWorkspaceCreated(const SWorkspaceState& workspace) {
+    markChangedIfOwned(workspace.id);
+}
+
+void CVirtualDesktopManager::onWorkspaceDestroyed(WORKSPACEID id) {
+    // The ID stays reserved for its desktop: the workspace is created again
+    // the next time the desktop is shown
+    m_reclaimer.cancel(id);
+    refreshOccupancy(id);
+
+    // Bumps the generation if the workspace is ours; whatever it still
+    // counted is gone with it
+    onCountersChanged(id);
+    publishWindowCounters();
+}
+
+void CVirtualDesktopManager::onWorkspaceMoved(WORKSPACEID id, MONITORID) {
+    markChangedIfOwned(id);
+}
+
+void CVirtualDesktopManager::onWorkspaceActivated(MONITORID, WORKSPACEID id) {
+    markChangedIfOwned(id);
+}
+
+void CVirtualDesktopManager::onWindowOpened(const SWindowState&) {
+    publishWindowCounters();
+}
+
+void CVirtualDesktopManager::onWindowClosed(WINDOWID) {
+    publishWindowCounters();
+}
+
+void CVirtualDesktopManager::onWindowMoved(WINDOWID, WORKSPACEID) {
+    publishWindowCounters();
+}
+
+void CVirtualDesktopManager::onWindowFullscreen(WINDOWID, bool) {
+    publishWindowCounters();
+}
+
+void CVirtualDesktopManager::onWindowUrgent(WINDOWID, bool) {
+    publishWindowCounters();
+}
+
+} // namespace VDM
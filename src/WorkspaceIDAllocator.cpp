@@ -0,0 +1,101 @@
+#include "WorkspaceIDAllocator.hpp"
+
+#include <bit>
+
+namespace VDM {
+
+    WORKSPACEID CWorkspaceIDAllocator::findFree(WORKSPACEID first, WORKSPACEID last) const {
+        if (first < 1)
+            first = 1;
+        if (last > MAX_TRACKED_ID)
+            last = MAX_TRACKED_ID;
+        if (last < first)
+            return -1;
+
+        const size_t lastBit = static_cast<size_t>(last - 1);
+        size_t bit = static_cast<size_t>(first - 1);
+
+        while (bit <= lastBit) {
+            const size_t word = bit / BITS;
+
+            // Everything past the bitmap is free
+            if (word >= m_words.size())
+                return static_cast<WORKSPACEID>(bit + 1);
+
+            const uint64_t free = ~m_words[word] & (~0ULL << (bit % BITS));
+            if (free) {
+                const size_t found = word * BITS + std::countr_zero(free);
+                return found <= lastBit ? static_cast<WORKSPACEID>(found + 1) : -1;
+            }
+
+            bit = findNonFullWord(word + 1) * BITS;
+        }
+
+        return -1;
+    }
+
+    size_t CWorkspaceIDAllocator::findNonFullWord(size_t word) const {
+        size_t summary = word / BITS;
+        if (summary >= m_fullWords.size())
+            return word;
+
+        uint64_t notFull = ~m_fullWords[summary] & (~0ULL << (word % BITS));
+        while (!notFull) {
+            if (++summary >= m_fullWords.size())
+                return summary * BITS;
+            notFull = ~m_fullWords[summary];
+        }
+
+        return summary * BITS + std::countr_zero(notFull);
+    }
+
+    void CWorkspaceIDAllocator::markUsed(const WORKSPACEID id) {
+        if (!isTracked(id))
+            return;
+
+        const size_t bit = static_cast<size_t>(id - 1);
+        const size_t word = bit / BITS;
+        if (word >= m_words.size()) {
+            m_words.resize(word + 1, 0);
+            m_fullWords.resize(word / BITS + 1, 0);
+        }
+
+        const uint64_t mask = 1ULL << (bit % BITS);
+        if (m_words[word] & mask)
+            return;
+
+        m_words[word] |= mask;
+        ++m_usedCount;
+
+        if (m_words[word] == ~0ULL)
+            m_fullWords[word / BITS] |= 1ULL << (word % BITS);
+    }
+
+    void CWorkspaceIDAllocator::markFree(const WORKSPACEID id) {
+        if (!isUsed(id))
+            return;
+
+        const size_t bit = static_cast<size_t>(id - 1);
+        const size_t word = bit / BITS;
+
+        m_words[word] &= ~(1ULL << (bit % BITS));
+        m_fullWords[word / BITS] &= ~(1ULL << (word % BITS));
+        --m_usedCount;
+    }
+
+    bool CWorkspaceIDAllocator::isUsed(const WORKSPACEID id) const {
+        if (!isTracked(id))
+            return false;
+
+        const size_t bit = static_cast<size_t>(id - 1);
+        const size_t word = bit / BITS;
+        return word < m_words.size() && (m_words[word] & (1ULL << (bit % BITS)));
+    }
+
+    void CWorkspaceIDAllocator::clear() {
+        m_words.clear();
+        m_fullWords.clear();
+        m_usedCount = 0;
+    }
+
+} // namespace VDM
@@ -0,0 +1,97 @@
+#include "WorkspaceReclaimer.hpp"
+#include "workspace_manager.hpp"
+#include "Stats.hpp"
+
+#include <algorithm>
+
+namespace VDM {
+
+void CWorkspaceReclaimer::setBackend(ICompositorBackend* backend) {
+    m_pBackend = backend;
+    m_queue.clear();
+    m_deadlines.clear();
+    m_pendingCount = 0;
+}
+
+bool CWorkspaceReclaimer::isPending(const SCandidate& candidate) const {
+    auto it = m_deadlines.find(candidate.id);
+    return it != m_deadlines.end() && it->second == candidate.deadline;
+}
+
+void CWorkspaceReclaimer::schedule(WORKSPACEID id) {
+    if (!m_pBackend || id == -1)
+        return;
+
+    const auto now = Clock::now();
+    const bool wasIdle = m_pendingCount == 0;
+
+    auto& deadline = m_deadlines[id];
+    if (deadline == Clock::time_point{})
+        ++m_pendingCount;
+    deadline = now + m_gracePeriod;
+    m_queue.push_back({.id = id, .deadline = deadline});
+
+    // Otherwise the timer is already set for an earlier deadline
+    if (wasIdle)
+        armTimer(now);
+}
+
+void CWorkspaceReclaimer::cancel(WORKSPACEID id) {
+    auto it = m_deadlines.find(id);
+    if (it == m_deadlines.end() || it->second == Clock::time_point{})
+        return;
+
+    it->second = {};
+    --m_pendingCount;
+}
+
+void CWorkspaceReclaimer::dispatch() {
+    if (!m_pBackend)
+        return;
+
+    VDM_STAT_SCOPE(STAT_WORKSPACE_RECLAIM);
+
+    const auto now = Clock::now();
+    auto* workspaces = CWorkspaceManager::getInstance();
+
+    m_releases.clear();
+    size_t checked = 0;
+    while (!m_queue.empty() && m_queue.front().deadline <= now && checked < m_budget) {
+        const SCandidate candidate = m_queue.front();
+        m_queue.pop_front();
+
+        if (!isPending(candidate))
+            continue;
+        cancel(candidate.id);
+        ++checked;
+
+        const auto workspace = workspaces->getWorkspaceView(candidate.id);
+        if (workspace && !workspace->isActive && workspace->windows.windows == 0)
+            m_releases.push_back(candidate.id);
+        else
+            ++m_keptCount;
+    }
+    ++m_sweepCount;
+
+    if (!m_releases.empty()) {
+        m_reclaimedCount += m_releases.size();
+        m_pBackend->releaseWorkspaces(m_releases);
+    }
+
+    armTimer(now);
+}
+
+void CWorkspaceReclaimer::armTimer(Clock::time_point now) {
+    // Drop stale entries so the timer is set for a live deadline
+    while (!m_queue.empty() && !isPending(m_queue.front()))
+        m_queue.pop_front();
+
+    if (!m_timerCallback || m_queue.empty())
+        return;
+
+    // A sweep that ran out of budget continues on the next iteration
+    const auto delay = std::chrono::ceil<std::chrono::milliseconds>(m_queue.front().deadline - now).count();
+    m_timerCallback(static_cast<int>(std::max<int64_t>(delay, 1)));
+}
+
+} // namespace VDM
@@ -0,0 +1,440 @@
+#include "globals.hpp"
+#include "command_handlers.hpp"
+#include "VirtualDesktopManager.hpp"
+#include "PerfectHash.hpp"
+#include "RequestArena.hpp"
+#include "Serializer.hpp"
+#include "Stats.hpp"
+#include "Trace.hpp"
+#include "workspace_manager.hpp"
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <format>
+
+namespace VDM::Commands {
+
+    namespace {
+
+        /**
+         * Serialized listing for one state generation, one per output format
+         */
+        struct SListingCache {
+            uint64_t generation = 0;
+            std::string text;
+        };
+
+        SListingCache gListingCache[2];
+
+        constexpr int ACTIVE_DESKTOP = -1;
+
+        /**
+         * Query plan for a listing, parsed once from the command arguments
+         */
+        struct SListingQuery {
+            std::optional<uint64_t> since;
+            uint32_t fields = DESKTOP_FIELDS_ALL;
+            std::string_view monitor;   // Selector, empty for all monitors
+            int desktop = 0;            // Desktop ID, 0 for all, ACTIVE_DESKTOP
+            bool occupied = false;
+
+            // Anything but the full listing bypasses the cache
+            bool isFiltered() const { return fields != DESKTOP_FIELDS_ALL || !monitor.empty() || desktop != 0 || occupied; }
+        };
+
+        /**
+         * Split the next space-separated token off the front of `args`
+         * @return The token, empty once `args` holds nothing but spaces
+         */
+        std::string_view nextToken(std::string_view& args) {
+            args.remove_prefix(std::min(args.find_first_not_of(' '), args.size()));
+            const size_t end = std::min(args.find(' '), args.size());
+            const std::string_view token = args.substr(0, end);
+            args.remove_prefix(end);
+            return token;
+        }
+
+        template <typename T>
+        bool parseNumber(std::string_view text, T& value) {
+            const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+            return ec == std::errc() && end == text.data() + text.size();
+        }
+
+        bool parseFields(std::string_view list, uint32_t& fields) {
+            static constexpr std::pair<std::string_view, uint32_t> FIELDS[] = {
+                {"id", DESKTOP_FIELD_ID},
+                {"name", DESKTOP_FIELD_NAME},
+                {"active", DESKTOP_FIELD_ACTIVE},
+                {"workspaces", DESKTOP_FIELD_WORKSPACES},
+                {"windows", DESKTOP_FIELD_WINDOWS},
+                {"fullscreen", DESKTOP_FIELD_FULLSCREEN},
+                {"urgent", DESKTOP_FIELD_URGENT},
+                {"occupied", DESKTOP_FIELD_OCCUPIED},
+            };
+
+            fields = 0;
+            if (list == "none")
+                return true;
+
+            while (!list.empty()) {
+                const size_t comma = list.find(',');
+                const std::string_view name = list.substr(0, comma);
+                const auto* it = std::ranges::find(FIELDS, name, &std::pair<std::string_view, uint32_t>::first);
+                if (it == std::end(FIELDS))
+                    return false;
+                fields |= it->second;
+                list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+            }
+            return fields != 0;
+        }
+
+        /**
+         * Parse `since=<gen> fields=<a,b,..|none> monitor=<sel> desktop=<id|active> occupied=<0|1>`
+         * @param error Set to the offending argument when parsing fails
+         */
+        std::optional<SListingQuery> parseQuery(std::string_view args, std::string_view& error) {
+            SListingQuery query;
+
+            while (!args.empty()) {
+                const std::string_view token = nextToken(args);
+                if (token.empty())
+                    continue;
+
+                const size_t eq = token.find('=');
+                const std::string_view key = token.substr(0, eq);
+                const std::string_view value = eq == std::string_view::npos ? std::string_view{} : token.substr(eq + 1);
+
+                bool valid = true;
+                if (eq == std::string_view::npos) {
+                    valid = false;
+                } else if (key == "since") {
+                    uint64_t generation = 0;
+                    valid = parseNumber(value, generation);
+                    query.since = generation;
+                } else if (key == "fields") {
+                    valid = parseFields(value, query.fields);
+                } else if (key == "monitor") {
+                    query.monitor = value;
+                    valid = !value.empty();
+                } else if (key == "desktop") {
+                    if (value == "active")
+                        query.desktop = ACTIVE_DESKTOP;
+                    else
+                        valid = parseNumber(value, query.desktop) && query.desktop >= 1;
+                } else if (key == "occupied") {
+                    valid = value == "0" || value == "1";
+                    query.occupied = value == "1";
+                } else {
+                    valid = false;
+                }
+
+                if (!valid) {
+                    error = token;
+                    return std::nullopt;
+                }
+            }
+
+            return query;
+        }
+
+        /**
+         * Scratch buffer for a reply, in the request arena
+         * Handlers serialize into it and copy it out once, into the
+         * std::string Hyprland takes.
+         */
+        std::pmr::string makeBuffer() {
+            return std::pmr::string(CRequestArena::getResource());
+        }
+
+        std::string errorReply(eHyprCtlOutputFormat format, std::string_view message) {
+            auto reply = makeBuffer();
+            CSerializer out(reply, format);
+            out.beginObject();
+            out.field("error", message);
+            out.endObject();
+            return std::string(reply);
+        }
+
+        /**
+         * Error reply with a formatted message, formatted in the request arena
+         */
+        template <typename... Args>
+            requires(sizeof...(Args) > 0)
+        std::string errorReply(eHyprCtlOutputFormat format, std::format_string<Args...> message, Args&&... args) {
+            auto text = makeBuffer();
+            std::format_to(std::back_inserter(text), message, std::forward<Args>(args)...);
+            return errorReply(format, std::string_view(text));
+        }
+
+        /**
+         * Serialize the desktops selected by a query
+         * Fields left out of the query are never computed: window counters
+         * are only looked up when a counter is requested, and the occupancy
+         * mask is only formatted when `occupied` is. occupied=1 reads the
+         * occupancy bitset.
+         * @param slot Monitor slot to restrict workspaces, counters and occupancy to
+         */
+        template <typename Buffer>
+        void buildListing(Buffer& buffer, eHyprCtlOutputFormat format, uint64_t generation, const SListingQuery& query,
+                          std::optional<size_t> slot) {
+            auto& manager = CVirtualDesktopManager::getInstance();
+            const auto& layout = manager.getLayout();
+
+            CSerializer out(buffer, format);
+            out.beginObject();
+            out.field("generation", generation);
+            out.field("active", layout.getActiveDesktopID());
+
+            const auto& occupied = slot ? layout.getOccupied(*slot) : layout.getOccupied();
+            if (query.fields & DESKTOP_FIELD_OCCUPIED) {
+                auto hex = makeBuffer();
+                occupied.appendHex(hex);
+                out.field("occupied", std::string_view(hex));
+            }
+
+            if (query.fields & DESKTOP_FIELDS_DESKTOP) {
+                const int wanted = query.desktop == ACTIVE_DESKTOP ? layout.getActiveDesktopID() : query.desktop;
+
+                out.beginArray("desktops");
+                const auto& desktops = layout.getDesktops();
+                for (size_t index = 0; index < desktops.size(); ++index) {
+                    const auto& desktop = desktops[index];
+                    if (wanted != 0 && desktop.getID() != wanted)
+                        continue;
+                    if (query.occupied && !occupied.test(index))
+                        continue;
+
+                    std::span<const WORKSPACEID> workspaces = desktop.getWorkspaceIDs();
+                    if (slot)
+                        workspaces = *slot < workspaces.size() ? workspaces.subspan(*slot, 1) : std::span<const WORKSPACEID>{};
+
+                    std::optional<SWindowCounters> counters;
+                    auto getCounters = [&] {
+                        if (!counters && !slot)
+                            counters = manager.getWindowCounters(desktop.getID());
+                        else if (!counters)
+                            counters = workspaces.empty() || workspaces[0] == -1
+                                ? SWindowCounters{}
+                                : CWorkspaceManager::getInstance()->getWindowCounters(workspaces[0]);
+                        return *counters;
+                    };
+
+                    serialize(out, desktop, query.fields, workspaces, getCounters);
+                }
+                out.endArray();
+            }
+
+            out.endObject();
+        }
+    }
+
+    std::string handleDbgPluginInfo(eHyprCtlOutputFormat format, std::string_view args) {
+        auto reply = makeBuffer();
+
+        // Scripts parse the one-line plain form, so it stays as it always was
+        if (format != eHyprCtlOutputFormat::FORMAT_JSON) {
+            std::format_to(std::back_inserter(reply), "{} v{} by {}\n", PLUGIN_NAME, PLUGIN_VERSION, PLUGIN_AUTHOR);
+            return std::string(reply);
+        }
+
+        CSerializer out(reply, format);
+        out.beginObject();
+        out.field("status", "ok");
+        out.field("plugin", PLUGIN_NAME);
+        out.field("version", PLUGIN_VERSION);
+        out.field("author", PLUGIN_AUTHOR);
+        out.endObject();
+        return std::string(reply);
+    }
+
+    std::string handleVirtualDesktopList(eHyprCtlOutputFormat format, std::string_view args) {
+        const uint64_t generation = CVirtualDesktopManager::getInstance().getGeneration();
+        const bool json = format == eHyprCtlOutputFormat::FORMAT_JSON;
+
+        std::string_view invalid;
+        const auto query = parseQuery(args, invalid);
+        if (!query)
+            return errorReply(format, "invalid argument '{}'", invalid);
+
+        // The client already has this generation: tell it so instead of resending
+        if (query->since == generation) {
+            if (json)
+                return std::format(R"({{"generation": {}, "unchanged": true}})", generation);
+            return std::format("unchanged {}\n", generation);
+        }
+
+        std::optional<size_t> slot;
+        if (!query->monitor.empty()) {
+            // Only the ID is needed: resolving the selector does not touch the backend
+            const MONITORID monitor = CWorkspaceManager::getInstance()->resolveMonitorID(query->monitor);
+            if (monitor != -1)
+                slot = CVirtualDesktopManager::getInstance().getLayout().getSlot(monitor);
+            if (!slot)
+                return errorReply(format, "unknown monitor '{}'", query->monitor);
+        }
+
+        if (query->isFiltered()) {
+            auto listing = makeBuffer();
+            buildListing(listing, format, generation, *query, slot);
+            return std::string(listing);
+        }
+
+        // The full listing is built straight into the cache, whose buffer is
+        // reused across generations; the reply is its only copy
+        auto& cache = gListingCache[json ? 1 : 0];
+        if (cache.generation != generation) {
+            cache.text.clear();
+            buildListing(cache.text, format, generation, *query, slot);
+            cache.generation = generation;
+        }
+
+        return cache.text;
+    }
+
+    std::string handleStats(eHyprCtlOutputFormat format, std::string_view args) {
+        bool reset = false;
+
+        while (!args.empty()) {
+            const std::string_view token = nextToken(args);
+            if (token.empty())
+                continue;
+            if (token != "reset")
+                return errorReply(format, "invalid argument '{}'", token);
+            reset = true;
+        }
+
+        auto reply = makeBuffer();
+        CSerializer out(reply, format);
+        out.beginObject();
+
+        if (reset) {
+            Stats::reset();
+            out.field("status", "ok");
+            out.endObject();
+            return std::string(reply);
+        }
+
+        out.field("unit", "ns");
+        out.field("allocsTracked", Stats::isCountingAllocations());
+        out.beginArray("ops");
+        for (uint8_t op = 0; op < STAT_COUNT; ++op) {
+            const SStatSummary summary = Stats::getSummary(static_cast<eStatOp>(op));
+            if (summary.count == 0)
+                continue;
+
+            out.beginObject({}, "op");
+            out.keyField("name", summary.name);
+            out.field("count", summary.count);
+            out.field("mean", summary.meanNs);
+            out.field("p50", summary.p50Ns);
+            out.field("p90", summary.p90Ns);
+            out.field("p99", summary.p99Ns);
+            out.field("max", summary.maxNs);
+            out.field("allocs", summary.allocs);
+            out.endObject();
+        }
+        out.endArray();
+
+        auto& desktops = CVirtualDesktopManager::getInstance();
+        out.beginObject("switches");
+        out.field("requested", desktops.getSwitchRequestCount());
+        out.field("coalesced", desktops.getCoalescedCount());
+        out.field("instant", desktops.getInstantSwitchCount());
+        out.endObject();
+
+        const auto& reclaimer = desktops.getReclaimer();
+        out.beginObject("reclaim");
+        out.field("pending", reclaimer.getPendingCount());
+        out.field("reclaimed", reclaimer.getReclaimedCount());
+        out.field("kept", reclaimer.getKeptCount());
+        out.field("sweeps", reclaimer.getSweepCount());
+        out.endObject();
+
+        out.endObject();
+        return std::string(reply);
+    }
+
+    std::string handleTrace(eHyprCtlOutputFormat format, std::string_view args) {
+        std::string_view tokens[3];
+        size_t count = 0;
+
+        while (!args.empty()) {
+            const std::string_view token = nextToken(args);
+            if (token.empty())
+                continue;
+            if (count == std::size(tokens))
+                return errorReply(format, "invalid argument '{}'", token);
+            tokens[count++] = token;
+        }
+
+        const std::string_view action = count > 0 ? tokens[0] : std::string_view{};
+
+        auto reply = makeBuffer();
+        CSerializer out(reply, format);
+        out.beginObject();
+
+        if (action == "start" && count == 1) {
+            Trace::start();
+            out.field("status", "ok");
+        } else if (action == "stop" && count == 2) {
+            Trace::stop();
+            const std::string_view path = tokens[1];
+            size_t events = 0;
+            if (!Trace::write(path, events))
+                return errorReply(format, "failed to write '{}'", path);
+            out.field("status", "ok");
+            out.field("path", path);
+            out.field("events", events);
+        } else {
+            return errorReply(format, "usage: vdm trace start | vdm trace stop <path>");
+        }
+
+        out.endObject();
+        return std::string(reply);
+    }
+
+    namespace {
+
+        // Subcommands of `hyprctl vdm`; adding one is adding an entry here
+        constexpr SSubcommand SUBCOMMANDS[] = {
+            {.name = "info", .fn = handleDbgPluginInfo, .stat = STAT_COMMAND_INFO},
+            {.name = "list", .fn = handleVirtualDesktopList, .stat = STAT_COMMAND_LIST},
+            {.name = "stats", .fn = handleStats, .stat = STAT_COMMAND_STATS},
+            {.name = "trace", .fn = handleTrace, .stat = STAT_COMMAND_TRACE},
+        };
+
+        constexpr CPerfectHashTable SUBCOMMAND_TABLE{SUBCOMMANDS};
+
+        std::string usageReply(eHyprCtlOutputFormat format) {
+            auto usage = makeBuffer();
+            usage += "usage: vdm <";
+            for (const auto& subcommand : SUBCOMMANDS) {
+                if (&subcommand != SUBCOMMANDS)
+                    usage += '|';
+                usage += subcommand.name;
+            }
+            usage += "> [args]";
+            return errorReply(format, std::string_view(usage));
+        }
+    }
+
+    std::string handleCommand(eHyprCtlOutputFormat format, std::string_view args) {
+        std::string_view name = nextToken(args);
+        if (name == CMD_DISPATCH_VDM_STR)
+            name = nextToken(args);
+
+        const SSubcommand* subcommand = SUBCOMMAND_TABLE.find(name);
+        if (!subcommand)
+            return usageReply(format);
+
+        VDM_STAT_SCOPE(subcommand->stat);
+        CRequestArena::CScope scope;
+        return subcommand->fn(format, args);
+    }
+
+} // namespace VDM::Commands
@@ -0,0 +1,57 @@
+#include "globals.hpp"
+#include "dispatchers.hpp"
+#include "VirtualDesktopManager.hpp"
+#include "workspace_manager.hpp"
+#include "Stats.hpp"
+#include <charconv>
+#include <format>
+#include <string_view>
+
+namespace VDM::Dispatchers {
+
+    SDispatchResult dispatchVirtualDesktop(std::string args) {
+        VDM_STAT_SCOPE(STAT_DISPATCH_VDESK);
+
+        std::string_view arg = args;
+        while (!arg.empty() && arg.front() == ' ')
+            arg.remove_prefix(1);
+        while (!arg.empty() && arg.back() == ' ')
+            arg.remove_suffix(1);
+
+        auto& desktops = CVirtualDesktopManager::getInstance();
+
+        int id = 0;
+        if (arg == "next-occupied" || arg == "prev-occupied") {
+            // Relative to a switch still pending, so that a held key keeps moving
+            const auto occupied = desktops.findOccupiedDesktop(desktops.getTargetDesktopID(), arg == "next-occupied");
+            if (!occupied)
+                return {.success = false, .error = "vdesk: no desktop has windows"};
+            id = *occupied;
+        } else {
+            const auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), id);
+            if (ec != std::errc() || end != arg.data() + arg.size() || id < 1 ||
+                id > CVirtualDesktopManager::MAX_DESKTOPS)
+                return {.success = false, .error = std::format("vdesk: invalid desktop '{}'", arg)};
+        }
+
+        // Under key repeat only the last of the requests within a frame is shown
+        if (!desktops.requestSwitch(id))
+            return {.success = false, .error = std::format("vdesk: failed to switch to desktop {}", id)};
+
+        return {};
+    }
+
+    void registerAll(HANDLE handle) {
+        VDM_TRACE_SCOPE("Dispatchers::registerAll");
+
+        if (!HyprlandAPI::addDispatcherV2(handle, DISPATCH_VDESK_STR, dispatchVirtualDesktop)) {
+            CWorkspaceManager::getInstance()->getNotifications().post(NotifyTopics::COMMAND_FAILED, NOTIFY_ERROR,
+                                                                      "Failed to register dispatcher: {}",
+                                                                      DISPATCH_VDESK_STR);
+        }
+    }
+
+    void unregisterAll(HANDLE handle) {
+        HyprlandAPI::removeDispatcher(handle, DISPATCH_VDESK_STR);
+    }
+}
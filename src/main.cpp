@@ -1,7 +1,240 @@
 #include <hyprland/src/plugins/PluginAPI.hpp>
 #include "globals.hpp"
 #include "commands.hpp"
+#include "dispatchers.hpp"
+#include "workspace_manager.hpp"
+#include "VirtualDesktopManager.hpp"
+#include "HyprlandBackend.hpp"
+#include "EventServer.hpp"
+#include "LoggerFacade.hpp"
+#include "Trace.hpp"
 
+#include <hyprland/src/Compositor.hpp>
+#include <wayland-server-core.h>
+#include <algorithm>
+#include <any>
+#include <cstdlib>
+#include <memory>
+
+// Compositor backend shared by the VDM core
+static std::unique_ptr<VDM::CHyprlandBackend> g_pBackend;
+
+// Event socket for bars and scripts, driven from the compositor event loop
+static std::unique_ptr<VDM::CEventServer> g_pEventServer;
+static wl_event_source* g_pEventSource = nullptr;
+
+static void startEventServer() {
+    const auto path = VDM::CEventServer::getDefaultPath();
+    if (!path || !g_pCompositor)
+        return;
+
+    g_pEventServer = std::make_unique<VDM::CEventServer>();
+    if (!g_pEventServer->start(*path)) {
+        g_pEventServer.reset();
+        return;
+    }
+
+    g_pEventSource = wl_event_loop_add_fd(g_pCompositor->m_wlEventLoop, g_pEventServer->getFD(), WL_EVENT_READABLE,
+        [](int, uint32_t, void*) {
+            if (g_pEventServer)
+                g_pEventServer->dispatch();
+            return 0;
+        },
+        nullptr);
+
+    VDM::CVirtualDesktopManager::getInstance().setEventServer(g_pEventServer.get());
+}
+
+// Timer that posts the summaries of merged notification bursts
+static wl_event_source* g_pNotifyTimer = nullptr;
+static SP<HOOK_CALLBACK_FN> g_pConfigReloadedCallback;
+
+// Log records are written by a flusher thread, so a slow disk or a stalled
+// stdout pipe never blocks the compositor; records that do not fit are dropped
+static AppLog::AsyncOptions getLoggingOptions() {
+    AppLog::AsyncOptions async{.enabled = true, .overflow = AppLog::OverflowPolicy::Drop};
+
+    const auto* value = HyprlandAPI::getConfigValue(PHANDLE, "plugin:vdm:log_queue");
+    if (!value)
+        return async;
+
+    const auto capacity = std::max<Hyprlang::INT>(std::any_cast<Hyprlang::INT>(value->getValue()), 0);
+    async.enabled = capacity > 0;
+    if (async.enabled)
+        async.capacity = static_cast<size_t>(capacity);
+    return async;
+}
+
+static void applyLoggingConfig() {
+    AppLog::setAsyncOptions(getLoggingOptions());
+}
+
+static void startLogging() {
+    // Records the log queue holds, 0 to write on the compositor thread
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:vdm:log_queue", Hyprlang::INT{1024});
+    AppLog::initLogging(true, true, nullptr, "", getLoggingOptions());
+
+    // VDM_BINARY_LOG=<path> switches to the binary log from plugin load;
+    // shutdownLogging() closes it
+    if (const char* path = std::getenv("VDM_BINARY_LOG"); path && *path)
+        AppLog::openBinaryLog(path);
+}
+
+static void applySwitchConfig() {
+    const auto* value = HyprlandAPI::getConfigValue(PHANDLE, "plugin:vdm:instant_switch_ms");
+    if (!value)
+        return;
+
+    const auto threshold = std::max<Hyprlang::INT>(std::any_cast<Hyprlang::INT>(value->getValue()), 0);
+    VDM::CVirtualDesktopManager::getInstance().setInstantThreshold(std::chrono::milliseconds(threshold));
+}
+
+static void applyNotificationConfig() {
+    const auto* value = HyprlandAPI::getConfigValue(PHANDLE, "plugin:vdm:notifications");
+    if (!value)
+        return;
+
+    const auto verbosity = std::clamp<Hyprlang::INT>(std::any_cast<Hyprlang::INT>(value->getValue()),
+                                                     VDM::NOTIFY_VERBOSITY_OFF, VDM::NOTIFY_VERBOSITY_ALL);
+    VDM::CWorkspaceManager::getInstance()->getNotifications().setVerbosity(static_cast<VDM::eNotifyVerbosity>(verbosity));
+}
+
+static void startNotifications() {
+    // 0 off, 1 errors, 2 warnings and errors, 3 everything
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:vdm:notifications", Hyprlang::INT{VDM::NOTIFY_VERBOSITY_ALL});
+    // Switch without animation when vdesk requests come faster than this many ms, 0 to always animate
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:vdm:instant_switch_ms", Hyprlang::INT{0});
+    applyNotificationConfig();
+    applySwitchConfig();
+    g_pConfigReloadedCallback = HyprlandAPI::registerCallbackDynamic(PHANDLE, "configReloaded",
+        [](void*, SCallbackInfo&, std::any) {
+            applyLoggingConfig();
+            applyNotificationConfig();
+            applySwitchConfig();
+        });
+
+    if (!g_pCompositor)
+        return;
+
+    g_pNotifyTimer = wl_event_loop_add_timer(g_pCompositor->m_wlEventLoop,
+        [](void*) {
+            VDM::CWorkspaceManager::getInstance()->getNotifications().dispatch();
+            return 0;
+        },
+        nullptr);
+
+    VDM::CWorkspaceManager::getInstance()->getNotifications().setTimerCallback([](int delayMs) {
+        if (g_pNotifyTimer)
+            wl_event_source_timer_update(g_pNotifyTimer, delayMs);
+    });
+}
+
+static void stopNotifications() {
+    VDM::CWorkspaceManager::getInstance()->getNotifications().setTimerCallback(nullptr);
+
+    if (g_pNotifyTimer)
+        wl_event_source_remove(g_pNotifyTimer);
+    g_pNotifyTimer = nullptr;
+
+    g_pConfigReloadedCallback.reset();
+}
+
+// Timer that makes the desktop switch deferred by switch coalescing
+static wl_event_source* g_pSwitchTimer = nullptr;
+
+static void startSwitchTimer() {
+    if (!g_pCompositor)
+        return;
+
+    g_pSwitchTimer = wl_event_loop_add_timer(g_pCompositor->m_wlEventLoop,
+        [](void*) {
+            VDM::CVirtualDesktopManager::getInstance().flushSwitch();
+            return 0;
+        },
+        nullptr);
+
+    VDM::CVirtualDesktopManager::getInstance().setSwitchTimerCallback([](int delayMs) {
+        if (g_pSwitchTimer)
+            wl_event_source_timer_update(g_pSwitchTimer, delayMs);
+    });
+}
+
+static void stopSwitchTimer() {
+    VDM::CVirtualDesktopManager::getInstance().setSwitchTimerCallback(nullptr);
+
+    if (g_pSwitchTimer)
+        wl_event_source_remove(g_pSwitchTimer);
+    g_pSwitchTimer = nullptr;
+}
+
+// Timer for the reclaimer's next deadline. The sweep itself runs from an idle
+// source, once the event loop has dispatched everything else pending
+static wl_event_source* g_pReclaimTimer = nullptr;
+static wl_event_source* g_pReclaimIdle = nullptr;
+
+static void startReclaimer() {
+    if (!g_pCompositor)
+        return;
+
+    g_pReclaimTimer = wl_event_loop_add_timer(g_pCompositor->m_wlEventLoop,
+        [](void*) {
+            if (g_pReclaimIdle)
+                return 0;
+
+            // Idle sources are destroyed by the event loop after they ran
+            g_pReclaimIdle = wl_event_loop_add_idle(g_pCompositor->m_wlEventLoop,
+                [](void*) {
+                    g_pReclaimIdle = nullptr;
+                    VDM::CVirtualDesktopManager::getInstance().getReclaimer().dispatch();
+                },
+                nullptr);
+            return 0;
+        },
+        nullptr);
+
+    VDM::CVirtualDesktopManager::getInstance().getReclaimer().setTimerCallback([](int delayMs) {
+        if (g_pReclaimTimer)
+            wl_event_source_timer_update(g_pReclaimTimer, delayMs);
+    });
+}
+
+static void stopReclaimer() {
+    VDM::CVirtualDesktopManager::getInstance().getReclaimer().setTimerCallback(nullptr);
+
+    if (g_pReclaimIdle)
+        wl_event_source_remove(g_pReclaimIdle);
+    g_pReclaimIdle = nullptr;
+
+    if (g_pReclaimTimer)
+        wl_event_source_remove(g_pReclaimTimer);
+    g_pReclaimTimer = nullptr;
+}
+
+static void stopEventServer() {
+    VDM::CVirtualDesktopManager::getInstance().setEventServer(nullptr);
+
+    if (g_pEventSource)
+        wl_event_source_remove(g_pEventSource);
+    g_pEventSource = nullptr;
+
+    g_pEventServer.reset();
+}
+
+// VDM_TRACE=<path> traces the plugin from load to unload, including startup
+static void startLoadTrace() {
+    if (const char* path = std::getenv("VDM_TRACE"); path && *path)
+        VDM::Trace::start();
+}
+
+static void stopLoadTrace() {
+    const char* path = std::getenv("VDM_TRACE");
+    if (!path || !*path || !VDM::Trace::isEnabled())
+        return;
+
+    VDM::Trace::stop();
+    size_t events = 0;
+    VDM::Trace::write(path, events);
+}
 
 // Plugin initialization
 APICALL EXPORT std::string PLUGIN_API_VERSION() {
@@ -11,12 +244,41 @@ APICALL EXPORT std::string PLUGIN_API_VERSION() {
 APICALL EXPORT PLUGIN_DESCRIPTION_INFO PLUGIN_INIT(HANDLE handle) {
     PHANDLE = handle;
 
+    startLoadTrace();
+    VDM_TRACE_SCOPE("PLUGIN_INIT");
+    startLogging();
+
+    g_pBackend = std::make_unique<VDM::CHyprlandBackend>(handle);
+    g_pBackend->init();
+
+    VDM::CWorkspaceManager::getInstance()->initialize(g_pBackend.get());
+    VDM::CVirtualDesktopManager::getInstance().initialize(g_pBackend.get());
+    startNotifications();
+    startReclaimer();
+    startSwitchTimer();
+    startEventServer();
     VDM::Commands::registerAll(handle);
+    VDM::Dispatchers::registerAll(handle);
     HyprlandAPI::addNotification(PHANDLE, "[VDM] Plugin loaded", CHyprColor(0.2, 0.8, 0.2, 1.0), 3000);
     return {VDM::PLUGIN_NAME, VDM::PLUGIN_DESCRIPTION, VDM::PLUGIN_AUTHOR, VDM::PLUGIN_VERSION};
 }
 
 APICALL EXPORT void PLUGIN_EXIT() {
-    VDM::Commands::unregisterAll(PHANDLE);
+    {
+        VDM_TRACE_SCOPE("PLUGIN_EXIT");
+        VDM::Dispatchers::unregisterAll(PHANDLE);
+        VDM::Commands::unregisterAll(PHANDLE);
+        stopEventServer();
+        stopSwitchTimer();
+        stopReclaimer();
+        stopNotifications();
+        VDM::CVirtualDesktopManager::getInstance().shutdown();
+        VDM::CWorkspaceManager::destroy();
+        g_pBackend.reset();
+    }
+    stopLoadTrace();
+
+    // The flusher thread must not outlive the plugin's code
+    AppLog::shutdownLogging();
     HyprlandAPI::addNotification(PHANDLE, "[VDM] Plugin unloaded", CHyprColor(0.8, 0.2, 0.2, 1.0), 3000);
 }
@@ -1,16 +1,22 @@
 #include "workspace_manager.hpp"
 #include "globals.hpp"
-#include <hyprland/src/Compositor.hpp>
-#include <hyprland/src/managers/LayoutManager.hpp>
+#include "LoggerFacade.hpp"
+#include "Stats.hpp"
 #include <algorithm>
 #include <format>
 
+#ifdef VDM_DEBUG_INDEX
+#define VDM_VERIFY_INDEX() verifyIndex()
+#else
+#define VDM_VERIFY_INDEX() ((void)0)
+#endif
+
 namespace VDM {
 
 // Initialize static member
 CWorkspaceManager* CWorkspaceManager::m_pInstance = nullptr;
 
-CWorkspaceManager::CWorkspaceManager() : m_hHandle(nullptr) {}
+CWorkspaceManager::CWorkspaceManager() : m_pBackend(nullptr) {}
 
 CWorkspaceManager* CWorkspaceManager::getInstance() {
     if (!m_pInstance) {
@@ -21,470 +27,726 @@ CWorkspaceManager* CWorkspaceManager::getInstance() {
 
 void CWorkspaceManager::destroy() {
     if (m_pInstance) {
+        if (m_pInstance->m_pBackend)
+            m_pInstance->m_pBackend->removeListener(m_pInstance);
         delete m_pInstance;
         m_pInstance = nullptr;
     }
 }
 
-void CWorkspaceManager::initialize(HANDLE handle) {
-    m_hHandle = handle;
+void CWorkspaceManager::initialize(ICompositorBackend* backend) {
+    if (m_pBackend)
+        m_pBackend->removeListener(this);
+
+    m_pBackend = backend;
+    m_notifications.setBackend(backend);
+    if (!m_pBackend)
+        return;
+
+    m_pBackend->addListener(this);
+    rebuildIndex();
+}
+
+MONITORID CWorkspaceManager::resolveMonitorID(std::string_view monitor) {
+    if (!m_pBackend)
+        return -1;
+
+    if (monitor == CMonitorResolver::CURRENT)
+        return getActiveMonitorID();
+
+    return m_monitorResolver.resolve(monitor);
+}
+
+SWorkspaceInfoView CWorkspaceManager::makeWorkspaceView(const SWorkspaceView& workspace) const {
+    SWorkspaceInfoView view;
+    view.id = workspace.id;
+    view.name = workspace.name;
+    view.monitorID = workspace.monitorID;
+
+    if (auto it = m_workspaceIndex.find(workspace.id); it != m_workspaceIndex.end()) {
+        view.monitorID = it->second.monitorID;
+        view.windows = it->second.windows;
+    }
+
+    view.monitorName = getIndexedMonitorName(view.monitorID);
+    view.isActive = isWorkspaceActive(workspace.id);
+    return view;
+}
+
+SMonitorInfoView CWorkspaceManager::makeMonitorView(const SMonitorView& monitor) const {
+    SMonitorInfoView view;
+    view.id = monitor.id;
+    view.name = monitor.name;
+    view.description = monitor.description;
+    view.width = monitor.width;
+    view.height = monitor.height;
+    view.refreshRate = monitor.refreshRate;
+    view.x = monitor.x;
+    view.y = monitor.y;
+
+    view.activeWorkspaceID = monitor.activeWorkspaceID;
+    if (monitor.activeWorkspaceID != -1) {
+        if (auto workspace = m_pBackend->getWorkspaceView(monitor.activeWorkspaceID))
+            view.activeWorkspaceName = workspace->name;
+    }
+
+    if (auto it = m_monitorIndex.find(monitor.id); it != m_monitorIndex.end())
+        view.workspaces = it->second.workspaces;
+
+    return view;
+}
+
+WorkspaceInfo CWorkspaceManager::toInfo(const SWorkspaceInfoView& view) {
+    WorkspaceInfo info;
+    info.id = view.id;
+    info.name = view.name;
+    info.monitorID = view.monitorID;
+    info.monitorName = view.monitorName;
+    info.windowCount = view.windows.windows;
+    info.isActive = view.isActive;
+    info.hasFullscreen = view.windows.fullscreen > 0;
+    info.hasUrgent = view.windows.urgent > 0;
+    return info;
+}
+
+MonitorInfo CWorkspaceManager::toInfo(const SMonitorInfoView& view) {
+    MonitorInfo info;
+    info.id = view.id;
+    info.name = view.name;
+    info.description = view.description;
+    info.width = view.width;
+    info.height = view.height;
+    info.refreshRate = view.refreshRate;
+    info.x = view.x;
+    info.y = view.y;
+    info.activeWorkspaceID = view.activeWorkspaceID;
+    info.activeWorkspaceName = view.activeWorkspaceName;
+    info.workspaces.assign(view.workspaces.begin(), view.workspaces.end());
+    return info;
+}
+
+// Index maintenance
+
+void CWorkspaceManager::rebuildIndex() {
+    m_workspaceIndex.clear();
+    m_monitorIndex.clear();
+    m_windowIndex.clear();
+    m_idAllocator.clear();
+    m_monitorResolver.clear();
+
+    if (!m_pBackend)
+        return;
+
+    for (const auto& monitor : m_pBackend->getMonitors())
+        indexAddMonitor(monitor);
+
+    for (const auto& workspace : m_pBackend->getWorkspaces())
+        indexAddWorkspace(workspace.id, workspace.monitorID);
+
+    for (const auto& window : m_pBackend->getWindows())
+        indexAddWindow(window);
+
+    if (m_occupancyCallback)
+        m_occupancyCallback(-1);
+    if (m_countersCallback)
+        m_countersCallback(-1);
+}
+
+void CWorkspaceManager::indexAddMonitor(const SMonitorState& monitor) {
+    const MONITORID id = monitor.id;
+    auto [it, inserted] = m_monitorIndex.try_emplace(id);
+    it->second.name = monitor.name;
+    it->second.activeWorkspaceID = monitor.activeWorkspaceID;
+    m_monitorResolver.addMonitor(monitor);
+
+    if (!inserted)
+        return;
+
+    // A monitor's first workspace is created before the monitor is announced,
+    // so pick up anything already indexed as living on it
+    for (const auto& [workspaceID, entry] : m_workspaceIndex) {
+        if (entry.monitorID == id)
+            it->second.workspaces.push_back(workspaceID);
+    }
+}
+
+void CWorkspaceManager::indexRemoveMonitor(MONITORID id) {
+    auto it = m_monitorIndex.find(id);
+    if (it == m_monitorIndex.end())
+        return;
+
+    // Workspaces still assigned here are moved away by the compositor, which
+    // emits a move event for each of them; detach whatever is left meanwhile
+    for (const auto workspaceID : it->second.workspaces) {
+        if (auto ws = m_workspaceIndex.find(workspaceID); ws != m_workspaceIndex.end())
+            ws->second.monitorID = -1;
+    }
+
+    m_monitorIndex.erase(it);
+    m_monitorResolver.removeMonitor(id);
+}
+
+void CWorkspaceManager::indexAddWorkspace(WORKSPACEID id, MONITORID monitorID) {
+    auto [it, inserted] = m_workspaceIndex.try_emplace(id);
+    if (!inserted) {
+        // Recreated with the same ID: drop the stale monitor assignment first
+        if (auto mon = m_monitorIndex.find(it->second.monitorID); mon != m_monitorIndex.end())
+            std::erase(mon->second.workspaces, id);
+    }
+
+    it->second.monitorID = monitorID;
+    m_idAllocator.markUsed(id);
+
+    // Windows already indexed on this ID (workspace recreated before its
+    // windows were moved away) count towards the new workspace
+    if (inserted) {
+        for (const auto& [windowID, window] : m_windowIndex) {
+            if (window.workspaceID == id)
+                applyWindowCounters(window, +1);
+        }
+    }
+
+    if (auto mon = m_monitorIndex.find(monitorID); mon != m_monitorIndex.end())
+        mon->second.workspaces.push_back(id);
+}
+
+void CWorkspaceManager::indexRemoveWorkspace(WORKSPACEID id) {
+    auto it = m_workspaceIndex.find(id);
+    if (it == m_workspaceIndex.end())
+        return;
+
+    if (auto mon = m_monitorIndex.find(it->second.monitorID); mon != m_monitorIndex.end()) {
+        std::erase(mon->second.workspaces, id);
+        if (mon->second.activeWorkspaceID == id)
+            mon->second.activeWorkspaceID = -1;
+    }
+
+    m_workspaceIndex.erase(it);
+    m_idAllocator.markFree(id);
+}
+
+void CWorkspaceManager::indexMoveWorkspace(WORKSPACEID id, MONITORID monitorID) {
+    auto it = m_workspaceIndex.find(id);
+    if (it == m_workspaceIndex.end()) {
+        indexAddWorkspace(id, monitorID);
+        return;
+    }
+
+    const MONITORID oldMonitorID = it->second.monitorID;
+    if (oldMonitorID == monitorID)
+        return;
+
+    if (auto mon = m_monitorIndex.find(oldMonitorID); mon != m_monitorIndex.end())
+        std::erase(mon->second.workspaces, id);
+
+    it->second.monitorID = monitorID;
+    if (auto mon = m_monitorIndex.find(monitorID); mon != m_monitorIndex.end())
+        mon->second.workspaces.push_back(id);
+
+    // Moving a workspace can change what both monitors are showing
+    indexRefreshActiveWorkspace(oldMonitorID);
+    indexRefreshActiveWorkspace(monitorID);
+}
+
+void CWorkspaceManager::indexSetActiveWorkspace(MONITORID monitorID, WORKSPACEID id) {
+    if (auto mon = m_monitorIndex.find(monitorID); mon != m_monitorIndex.end())
+        mon->second.activeWorkspaceID = id;
+}
+
+void CWorkspaceManager::indexRefreshActiveWorkspace(MONITORID monitorID) {
+    auto mon = m_monitorIndex.find(monitorID);
+    if (mon == m_monitorIndex.end())
+        return;
+
+    mon->second.activeWorkspaceID = m_pBackend->getActiveWorkspaceID(monitorID);
+}
+
+bool CWorkspaceManager::isWorkspaceActive(WORKSPACEID id) const {
+    auto ws = m_workspaceIndex.find(id);
+    if (ws == m_workspaceIndex.end())
+        return false;
+
+    auto mon = m_monitorIndex.find(ws->second.monitorID);
+    return mon != m_monitorIndex.end() && mon->second.activeWorkspaceID == id;
+}
+
+const std::string& CWorkspaceManager::getIndexedMonitorName(MONITORID id) const {
+    static const std::string UNKNOWN = "unknown";
+
+    auto mon = m_monitorIndex.find(id);
+    return mon != m_monitorIndex.end() ? mon->second.name : UNKNOWN;
+}
+
+void CWorkspaceManager::indexAddWindow(const SWindowState& window) {
+    indexRemoveWindow(window.id);
+
+    const SWindowIndexEntry entry{.workspaceID = window.workspaceID, .fullscreen = window.fullscreen, .urgent = window.urgent};
+    m_windowIndex.emplace(window.id, entry);
+    applyWindowCounters(entry, +1);
+}
+
+void CWorkspaceManager::indexRemoveWindow(WINDOWID id) {
+    auto it = m_windowIndex.find(id);
+    if (it == m_windowIndex.end())
+        return;
+
+    applyWindowCounters(it->second, -1);
+    m_windowIndex.erase(it);
+}
+
+void CWorkspaceManager::applyWindowCounters(const SWindowIndexEntry& window, int sign) {
+    auto it = m_workspaceIndex.find(window.workspaceID);
+    if (it == m_workspaceIndex.end())
+        return;
+
+    auto& counters = it->second.windows;
+    counters.windows += sign;
+    if (window.fullscreen)
+        counters.fullscreen += sign;
+    if (window.urgent)
+        counters.urgent += sign;
+
+    if (m_occupancyCallback && counters.windows == (sign > 0 ? 1u : 0u))
+        m_occupancyCallback(window.workspaceID);
+    if (m_countersCallback)
+        m_countersCallback(window.workspaceID);
+}
+
+bool CWorkspaceManager::verifyIndex() {
+    if (!m_pBackend)
+        return true;
+
+    size_t mismatches = 0;
+    auto report = [&mismatches](const std::string& what) {
+        ++mismatches;
+        AppLog::warn(AppLog::Category::Index, "{}", what);
+    };
+
+    const auto workspaces = m_pBackend->getWorkspaces();
+    for (const auto& workspace : workspaces) {
+        auto it = m_workspaceIndex.find(workspace.id);
+        if (it == m_workspaceIndex.end()) {
+            report(std::format("workspace {} missing from index", workspace.id));
+            continue;
+        }
+        if (CWorkspaceIDAllocator::isTracked(workspace.id) && !m_idAllocator.isUsed(workspace.id))
+            report(std::format("workspace {} not marked as used by the ID allocator", workspace.id));
+        if (it->second.monitorID != workspace.monitorID)
+            report(std::format("workspace {} indexed on monitor {}, actually on {}",
+                               workspace.id, it->second.monitorID, workspace.monitorID));
+    }
+    if (workspaces.size() != m_workspaceIndex.size())
+        report(std::format("index holds {} workspaces, compositor has {}", m_workspaceIndex.size(), workspaces.size()));
+
+    // Recount windows from scratch and compare with the counters
+    const auto windows = m_pBackend->getWindows();
+    std::unordered_map<WORKSPACEID, SWindowCounters> counted;
+    for (const auto& window : windows) {
+        auto& counters = counted[window.workspaceID];
+        counters.windows++;
+        counters.fullscreen += window.fullscreen;
+        counters.urgent += window.urgent;
+    }
+    for (const auto& [id, entry] : m_workspaceIndex) {
+        auto it = counted.find(id);
+        const SWindowCounters actual = it != counted.end() ? it->second : SWindowCounters{};
+        if (entry.windows != actual)
+            report(std::format("workspace {} counted {}/{}/{} windows/fullscreen/urgent, actually {}/{}/{}", id,
+                               entry.windows.windows, entry.windows.fullscreen, entry.windows.urgent,
+                               actual.windows, actual.fullscreen, actual.urgent));
+    }
+    if (windows.size() != m_windowIndex.size())
+        report(std::format("index holds {} windows, compositor has {}", m_windowIndex.size(), windows.size()));
+
+    const auto monitors = m_pBackend->getMonitors();
+    for (const auto& monitor : monitors) {
+        auto it = m_monitorIndex.find(monitor.id);
+        if (it == m_monitorIndex.end()) {
+            report(std::format("monitor {} missing from index", monitor.name));
+            continue;
+        }
+
+        if (m_monitorResolver.resolve(monitor.name) != monitor.id)
+            report(std::format("monitor {} does not resolve to ID {}", monitor.name, monitor.id));
+
+        if (it->second.activeWorkspaceID != monitor.activeWorkspaceID)
+            report(std::format("monitor {} indexed with active workspace {}, actually {}",
+                               monitor.name, it->second.activeWorkspaceID, monitor.activeWorkspaceID));
+
+        for (const auto workspaceID : it->second.workspaces) {
+            auto ws = m_workspaceIndex.find(workspaceID);
+            if (ws == m_workspaceIndex.end() || ws->second.monitorID != monitor.id)
+                report(std::format("monitor {} lists workspace {} it does not own", monitor.name, workspaceID));
+        }
+    }
+    if (monitors.size() != m_monitorIndex.size())
+        report(std::format("index holds {} monitors, compositor has {}", m_monitorIndex.size(), monitors.size()));
+
+    if (mismatches == 0)
+        return true;
+
+    AppLog::error(AppLog::Category::Index, "{} index mismatches, rebuilding", mismatches);
+    rebuildIndex();
+    return false;
+}
+
+// Backend events
+
+void CWorkspaceManager::onMonitorAdded(const SMonitorState& monitor) {
+    indexAddMonitor(monitor);
+}
+
+void CWorkspaceManager::onMonitorRemoved(MONITORID id) {
+    indexRemoveMonitor(id);
+}
+
+void CWorkspaceManager::onWorkspaceCreated(const SWorkspaceState& workspace) {
+    indexAddWorkspace(workspace.id, workspace.monitorID);
+}
+
+void CWorkspaceManager::onWorkspaceDestroyed(WORKSPACEID id) {
+    indexRemoveWorkspace(id);
+}
+
+void CWorkspaceManager::onWorkspaceMoved(WORKSPACEID id, MONITORID monitorID) {
+    indexMoveWorkspace(id, monitorID);
+}
+
+void CWorkspaceManager::onWorkspaceActivated(MONITORID monitorID, WORKSPACEID id) {
+    indexSetActiveWorkspace(monitorID, id);
+}
+
+void CWorkspaceManager::onWindowOpened(const SWindowState& window) {
+    indexAddWindow(window);
+}
+
+void CWorkspaceManager::onWindowClosed(WINDOWID id) {
+    indexRemoveWindow(id);
 }
 
-PHLWORKSPACE CWorkspaceManager::getWorkspaceByID(WORKSPACEID id) {
-    if (!g_pCompositor)
-        return nullptr;
-    
-    return g_pCompositor->getWorkspaceByID(id);
+void CWorkspaceManager::onWindowMoved(WINDOWID id, WORKSPACEID workspaceID) {
+    auto it = m_windowIndex.find(id);
+    if (it == m_windowIndex.end() || it->second.workspaceID == workspaceID)
+        return;
+
+    applyWindowCounters(it->second, -1);
+    it->second.workspaceID = workspaceID;
+    applyWindowCounters(it->second, +1);
 }
 
-CMonitor* CWorkspaceManager::getMonitorByID(MONITORID id) {
-    if (!g_pCompositor)
-        return nullptr;
-    
-    auto monitor = g_pCompositor->getMonitorFromID(id);
-    return monitor.get();
+void CWorkspaceManager::onWindowFullscreen(WINDOWID id, bool fullscreen) {
+    auto it = m_windowIndex.find(id);
+    if (it == m_windowIndex.end() || it->second.fullscreen == fullscreen)
+        return;
+
+    it->second.fullscreen = fullscreen;
+
+    // The window stays where it is, so occupancy does not change
+    auto workspace = m_workspaceIndex.find(it->second.workspaceID);
+    if (workspace == m_workspaceIndex.end())
+        return;
+
+    workspace->second.windows.fullscreen += fullscreen ? 1 : -1;
+    if (m_countersCallback)
+        m_countersCallback(it->second.workspaceID);
 }
 
-CMonitor* CWorkspaceManager::getMonitorByName(const std::string& name) {
-    if (!g_pCompositor)
-        return nullptr;
-    
-    auto monitor = g_pCompositor->getMonitorFromName(name);
-    return monitor.get();
+void CWorkspaceManager::onWindowUrgent(WINDOWID id, bool urgent) {
+    auto it = m_windowIndex.find(id);
+    if (it == m_windowIndex.end() || it->second.urgent == urgent)
+        return;
+
+    it->second.urgent = urgent;
+
+    // The window stays where it is, so occupancy does not change
+    auto workspace = m_workspaceIndex.find(it->second.workspaceID);
+    if (workspace == m_workspaceIndex.end())
+        return;
+
+    workspace->second.windows.urgent += urgent ? 1 : -1;
+    if (m_countersCallback)
+        m_countersCallback(it->second.workspaceID);
 }
 
 // Workspace management operations
 
 WORKSPACEID CWorkspaceManager::createWorkspace(std::optional<WORKSPACEID> id, const std::string& name) {
-    if (!g_pCompositor || !m_hHandle)
+    VDM_STAT_SCOPE(STAT_WORKSPACE_CREATE);
+
+    if (!m_pBackend)
         return -1;
 
     WORKSPACEID workspaceID = id.value_or(getNextAvailableWorkspaceID());
-    
+
     // Check if workspace already exists
     if (workspaceExists(workspaceID)) {
-        HyprlandAPI::addNotification(m_hHandle,
-            std::format("[VDM] Workspace {} already exists", workspaceID),
-            CHyprColor(0.8, 0.5, 0.2, 1.0), 3000);
+        m_notifications.post(NotifyTopics::WORKSPACE_REJECTED, NOTIFY_WARN, "[VDM] Workspace {} already exists", workspaceID);
         return -1;
     }
 
-    // Create workspace using Hyprland's compositor
-    auto monitor = getActiveMonitor();
-    if (!monitor) {
-        HyprlandAPI::addNotification(m_hHandle,
-            "[VDM] No active monitor found",
-            CHyprColor(0.8, 0.2, 0.2, 1.0), 3000);
+    // Create workspace on the active monitor
+    const MONITORID monitorID = getActiveMonitorID();
+    if (monitorID == -1) {
+        m_notifications.post(NotifyTopics::WORKSPACE_FAILED, NOTIFY_ERROR, "[VDM] No active monitor found");
         return -1;
     }
 
-    auto pMonitor = g_pCompositor->getMonitorFromID(monitor->m_id);
-    auto workspace = CWorkspace::create(workspaceID, pMonitor, name.empty() ? std::to_string(workspaceID) : name);
-    if (!workspace) {
-        HyprlandAPI::addNotification(m_hHandle,
-            std::format("[VDM] Failed to create workspace {}", workspaceID),
-            CHyprColor(0.8, 0.2, 0.2, 1.0), 3000);
+    const std::string workspaceName = name.empty() ? std::to_string(workspaceID) : name;
+    if (!m_pBackend->createWorkspace(workspaceID, monitorID, workspaceName)) {
+        m_notifications.post(NotifyTopics::WORKSPACE_FAILED, NOTIFY_ERROR, "[VDM] Failed to create workspace {}", workspaceID);
         return -1;
     }
 
-    HyprlandAPI::addNotification(m_hHandle,
-        std::format("[VDM] Created workspace {} ({})", workspaceID, 
-                   name.empty() ? std::to_string(workspaceID) : name),
-        CHyprColor(0.2, 0.8, 0.2, 1.0), 3000);
+    m_notifications.post(NotifyTopics::WORKSPACE_CREATED, NOTIFY_OK, "[VDM] Created workspace {} ({})", workspaceID,
+                         workspaceName);
 
     return workspaceID;
 }
 
 bool CWorkspaceManager::deleteWorkspace(WORKSPACEID id) {
-    if (!g_pCompositor || !m_hHandle)
+    VDM_STAT_SCOPE(STAT_WORKSPACE_DELETE);
+
+    if (!m_pBackend)
         return false;
 
-    auto workspace = getWorkspaceByID(id);
-    if (!workspace) {
-        HyprlandAPI::addNotification(m_hHandle,
-            std::format("[VDM] Workspace {} not found", id),
-            CHyprColor(0.8, 0.5, 0.2, 1.0), 3000);
+    if (!workspaceExists(id)) {
+        m_notifications.post(NotifyTopics::WORKSPACE_REJECTED, NOTIFY_WARN, "[VDM] Workspace {} not found", id);
         return false;
     }
 
     // Don't delete if it has windows
-    int windowCount = workspace->getWindows();
-    if (windowCount > 0) {
-        HyprlandAPI::addNotification(m_hHandle,
-            std::format("[VDM] Cannot delete workspace {} - contains {} windows", 
-                       id, windowCount),
-            CHyprColor(0.8, 0.5, 0.2, 1.0), 3000);
+    const SWindowCounters counters = getWindowCounters(id);
+    if (counters.windows > 0) {
+        m_notifications.post(NotifyTopics::WORKSPACE_REJECTED, NOTIFY_WARN,
+                             "[VDM] Cannot delete workspace {} - contains {} windows", id, counters.windows);
         return false;
     }
 
     // Don't delete if it's the active workspace on any monitor
-    for (const auto& monitor : g_pCompositor->m_realMonitors) {
-        if (!monitor)
-            continue;
-        auto activeWS = monitor->m_activeWorkspace;
-        if (activeWS && activeWS->m_id == id) {
-            HyprlandAPI::addNotification(m_hHandle,
-                std::format("[VDM] Cannot delete active workspace {}", id),
-                CHyprColor(0.8, 0.5, 0.2, 1.0), 3000);
-            return false;
-        }
+    if (isWorkspaceActive(id)) {
+        m_notifications.post(NotifyTopics::WORKSPACE_REJECTED, NOTIFY_WARN, "[VDM] Cannot delete active workspace {}", id);
+        return false;
     }
 
-    // We can't directly erase from m_workspaces since it's private
-    // Instead, Hyprland will cleanup when workspace is no longer referenced
-    workspace.reset();
-    
-    HyprlandAPI::addNotification(m_hHandle,
-        std::format("[VDM] Workspace {} marked for deletion", id),
-        CHyprColor(0.2, 0.8, 0.2, 1.0), 3000);
+    // Drop the plugin's references; the compositor destroys the workspace
+    // once nothing else holds it
+    m_pBackend->releaseWorkspaces(std::span(&id, 1));
+    m_notifications.post(NotifyTopics::WORKSPACE_DELETED, NOTIFY_OK, "[VDM] Deleted workspace {}", id);
 
     return true;
 }
 
 bool CWorkspaceManager::switchToWorkspace(WORKSPACEID id) {
-    if (!g_pCompositor || !m_hHandle)
+    VDM_STAT_SCOPE(STAT_WORKSPACE_SWITCH);
+
+    if (!m_pBackend)
         return false;
 
-    auto workspace = getWorkspaceByID(id);
-    if (!workspace) {
+    if (!workspaceExists(id)) {
         // Workspace doesn't exist, create it first
         WORKSPACEID newID = createWorkspace(id);
         if (newID == -1)
             return false;
-        workspace = getWorkspaceByID(newID);
-        if (!workspace)
+        if (!workspaceExists(newID))
             return false;
     }
 
     // Get current monitor and switch workspace
-    auto monitor = g_pCompositor->getMonitorFromCursor();
-    if (monitor) {
-        monitor->changeWorkspace(id);
-        return true;
-    }
+    const MONITORID monitorID = m_pBackend->getFocusedMonitorID();
+    if (monitorID == -1)
+        return false;
 
-    return false;
+    return m_pBackend->changeWorkspace(monitorID, id);
 }
 
 bool CWorkspaceManager::moveWorkspaceToMonitor(WORKSPACEID workspaceID, const std::string& monitorID) {
-    if (!g_pCompositor || !m_hHandle)
-        return false;
+    VDM_STAT_SCOPE(STAT_WORKSPACE_MOVE);
 
-    auto workspace = getWorkspaceByID(workspaceID);
-    if (!workspace) {
-        HyprlandAPI::addNotification(m_hHandle,
-            std::format("[VDM] Workspace {} not found", workspaceID),
-            CHyprColor(0.8, 0.5, 0.2, 1.0), 3000);
+    if (!m_pBackend)
         return false;
-    }
 
-    // Try to get monitor by name first, then by ID
-    CMonitor* monitor = getMonitorByName(monitorID);
-    if (!monitor) {
-        try {
-            MONITORID monID = std::stoll(monitorID);
-            monitor = getMonitorByID(monID);
-        } catch (...) {
-            // Invalid monitor ID
-        }
+    if (!workspaceExists(workspaceID)) {
+        m_notifications.post(NotifyTopics::WORKSPACE_REJECTED, NOTIFY_WARN, "[VDM] Workspace {} not found", workspaceID);
+        return false;
     }
 
-    if (!monitor) {
-        HyprlandAPI::addNotification(m_hHandle,
-            std::format("[VDM] Monitor {} not found", monitorID),
-            CHyprColor(0.8, 0.5, 0.2, 1.0), 3000);
+    const MONITORID targetID = resolveMonitorID(monitorID);
+    if (targetID == -1) {
+        m_notifications.post(NotifyTopics::WORKSPACE_REJECTED, NOTIFY_WARN, "[VDM] Monitor {} not found", monitorID);
         return false;
     }
 
-    // Move workspace to monitor
-    auto pMonitor = g_pCompositor->getMonitorFromID(monitor->m_id);
-    g_pCompositor->moveWorkspaceToMonitor(workspace, pMonitor);
+    if (!m_pBackend->moveWorkspaceToMonitor(workspaceID, targetID))
+        return false;
 
-    HyprlandAPI::addNotification(m_hHandle,
-        std::format("[VDM] Moved workspace {} to monitor {}", workspaceID, monitor->m_name),
-        CHyprColor(0.2, 0.8, 0.2, 1.0), 3000);
+    m_notifications.post(NotifyTopics::WORKSPACE_MOVED, NOTIFY_OK, "[VDM] Moved workspace {} to monitor {}", workspaceID,
+                         getIndexedMonitorName(targetID));
 
     return true;
 }
 
 bool CWorkspaceManager::renameWorkspace(WORKSPACEID id, const std::string& newName) {
-    if (!g_pCompositor || !m_hHandle)
+    VDM_STAT_SCOPE(STAT_WORKSPACE_RENAME);
+
+    if (!m_pBackend)
         return false;
 
-    auto workspace = getWorkspaceByID(id);
-    if (!workspace) {
-        HyprlandAPI::addNotification(m_hHandle,
-            std::format("[VDM] Workspace {} not found", id),
-            CHyprColor(0.8, 0.5, 0.2, 1.0), 3000);
+    if (!m_pBackend->renameWorkspace(id, newName)) {
+        m_notifications.post(NotifyTopics::WORKSPACE_REJECTED, NOTIFY_WARN, "[VDM] Workspace {} not found", id);
         return false;
     }
 
-    workspace->m_name = newName;
-
-    HyprlandAPI::addNotification(m_hHandle,
-        std::format("[VDM] Renamed workspace {} to '{}'", id, newName),
-        CHyprColor(0.2, 0.8, 0.2, 1.0), 3000);
+    m_notifications.post(NotifyTopics::WORKSPACE_RENAMED, NOTIFY_OK, "[VDM] Renamed workspace {} to '{}'", id, newName);
 
     return true;
 }
 
 // Query operations
 
-std::vector<WorkspaceInfo> CWorkspaceManager::getAllWorkspaces() {
-    std::vector<WorkspaceInfo> workspaces;
-    
-    if (!g_pCompositor)
-        return workspaces;
-
-    for (auto& workspace : g_pCompositor->getWorkspaces()) {
-        if (!workspace)
-            continue;
+void CWorkspaceManager::forEachWorkspace(CFunctionRef<void(const SWorkspaceInfoView&)> fn) {
+    VDM_STAT_SCOPE(STAT_QUERY_WORKSPACES);
 
-        WorkspaceInfo info;
-        info.id = workspace->m_id;
-        info.name = workspace->m_name;
-        info.monitorID = workspace->monitorID();
-        
-        auto monitor = getMonitorByID(workspace->monitorID());
-        info.monitorName = monitor ? monitor->m_name : "unknown";
-        
-        info.windowCount = workspace->getWindows();
-        
-        // Check if workspace is active on any monitor
-        info.isActive = false;
-        for (const auto& mon : g_pCompositor->m_realMonitors) {
-            if (!mon)
-                continue;
-            auto activeWS = mon->m_activeWorkspace;
-            if (activeWS && activeWS->m_id == workspace->m_id) {
-                info.isActive = true;
-                break;
-            }
-        }
-        
-        info.hasFullscreen = workspace->m_hasFullscreenWindow;
+    if (!m_pBackend)
+        return;
 
-        workspaces.push_back(info);
-    }
+    VDM_VERIFY_INDEX();
 
-    return workspaces;
+    // Walk the compositor list to keep its ordering, everything else comes from the index
+    m_pBackend->forEachWorkspace([&](const SWorkspaceView& workspace) { fn(makeWorkspaceView(workspace)); });
 }
 
-std::optional<WorkspaceInfo> CWorkspaceManager::getWorkspaceInfo(WORKSPACEID id) {
-    if (!g_pCompositor)
+std::optional<SWorkspaceInfoView> CWorkspaceManager::getWorkspaceView(WORKSPACEID id) {
+    if (!m_pBackend)
+        return std::nullopt;
+
+    VDM_VERIFY_INDEX();
+
+    if (!m_workspaceIndex.contains(id))
         return std::nullopt;
 
-    auto workspace = getWorkspaceByID(id);
+    auto workspace = m_pBackend->getWorkspaceView(id);
     if (!workspace)
         return std::nullopt;
 
-    WorkspaceInfo info;
-    info.id = workspace->m_id;
-    info.name = workspace->m_name;
-    info.monitorID = workspace->monitorID();
-    
-    auto monitor = getMonitorByID(workspace->monitorID());
-    info.monitorName = monitor ? monitor->m_name : "unknown";
-    
-    info.windowCount = workspace->getWindows();
-    
-    // Check if workspace is active on any monitor
-    info.isActive = false;
-    for (const auto& mon : g_pCompositor->m_realMonitors) {
-        if (!mon)
-            continue;
-        auto activeWS = mon->m_activeWorkspace;
-        if (activeWS && activeWS->m_id == workspace->m_id) {
-            info.isActive = true;
-            break;
-        }
-    }
-    
-    info.hasFullscreen = workspace->m_hasFullscreenWindow;
+    return makeWorkspaceView(*workspace);
+}
 
-    return info;
+std::vector<WorkspaceInfo> CWorkspaceManager::getAllWorkspaces() {
+    std::vector<WorkspaceInfo> workspaces;
+    workspaces.reserve(m_workspaceIndex.size());
+    forEachWorkspace([&](const SWorkspaceInfoView& view) { workspaces.push_back(toInfo(view)); });
+    return workspaces;
 }
 
-WORKSPACEID CWorkspaceManager::getActiveWorkspaceID() {
-    if (!g_pCompositor)
-        return -1;
+std::optional<WorkspaceInfo> CWorkspaceManager::getWorkspaceInfo(WORKSPACEID id) {
+    if (auto view = getWorkspaceView(id))
+        return toInfo(*view);
+    return std::nullopt;
+}
 
-    auto* monitor = getActiveMonitor();
-    if (!monitor)
+WORKSPACEID CWorkspaceManager::getActiveWorkspaceID() {
+    if (!m_pBackend)
         return -1;
 
-    auto workspace = monitor->m_activeWorkspace;
-    if (!workspace)
+    auto it = m_monitorIndex.find(getActiveMonitorID());
+    if (it == m_monitorIndex.end())
         return -1;
 
-    return workspace->m_id;
+    return it->second.activeWorkspaceID;
 }
 
-std::vector<WORKSPACEID> CWorkspaceManager::getWorkspacesOnMonitor(const std::string& monitorID) {
-    std::vector<WORKSPACEID> workspaceIDs;
-    
-    if (!g_pCompositor)
-        return workspaceIDs;
-
-    // Try to get monitor by name first, then by ID
-    CMonitor* monitor = getMonitorByName(monitorID);
-    if (!monitor) {
-        try {
-            MONITORID monID = std::stoll(monitorID);
-            monitor = getMonitorByID(monID);
-        } catch (...) {
-            return workspaceIDs;
-        }
-    }
+std::span<const WORKSPACEID> CWorkspaceManager::getWorkspacesOnMonitorView(std::string_view monitorID) {
+    if (!m_pBackend)
+        return {};
 
-    if (!monitor)
-        return workspaceIDs;
+    VDM_VERIFY_INDEX();
 
-    for (auto& workspace : g_pCompositor->getWorkspaces()) {
-        if (workspace && workspace->monitorID() == monitor->m_id) {
-            workspaceIDs.push_back(workspace->m_id);
-        }
-    }
+    if (auto it = m_monitorIndex.find(resolveMonitorID(monitorID)); it != m_monitorIndex.end())
+        return it->second.workspaces;
 
-    return workspaceIDs;
+    return {};
 }
 
-// Monitor operations
-
-std::vector<MonitorInfo> CWorkspaceManager::getAllMonitors() {
-    std::vector<MonitorInfo> monitors;
-    
-    if (!g_pCompositor)
-        return monitors;
+std::vector<WORKSPACEID> CWorkspaceManager::getWorkspacesOnMonitor(const std::string& monitorID) {
+    const auto ids = getWorkspacesOnMonitorView(monitorID);
+    return {ids.begin(), ids.end()};
+}
 
-    for (const auto& monitor : g_pCompositor->m_realMonitors) {
-        if (!monitor)
-            continue;
+// Monitor operations
 
-        MonitorInfo info;
-        info.id = monitor->m_id;
-        info.name = monitor->m_name;
-        info.description = monitor->m_description;
-        info.width = monitor->m_size.x;
-        info.height = monitor->m_size.y;
-        info.refreshRate = monitor->m_refreshRate;
-        info.x = monitor->m_position.x;
-        info.y = monitor->m_position.y;
-        
-        auto activeWorkspace = monitor->m_activeWorkspace;
-        if (activeWorkspace) {
-            info.activeWorkspaceID = activeWorkspace->m_id;
-            info.activeWorkspaceName = activeWorkspace->m_name;
-        } else {
-            info.activeWorkspaceID = -1;
-            info.activeWorkspaceName = "";
-        }
+void CWorkspaceManager::forEachMonitor(CFunctionRef<void(const SMonitorInfoView&)> fn) {
+    VDM_STAT_SCOPE(STAT_QUERY_MONITORS);
 
-        // Get all workspaces on this monitor
-        for (auto& workspace : g_pCompositor->getWorkspaces()) {
-            if (workspace && workspace->monitorID() == monitor->m_id) {
-                info.workspaces.push_back(workspace->m_id);
-            }
-        }
+    if (!m_pBackend)
+        return;
 
-        monitors.push_back(info);
-    }
+    VDM_VERIFY_INDEX();
 
-    return monitors;
+    m_pBackend->forEachMonitor([&](const SMonitorView& monitor) { fn(makeMonitorView(monitor)); });
 }
 
-std::optional<MonitorInfo> CWorkspaceManager::getMonitorInfo(const std::string& id) {
-    if (!g_pCompositor)
+std::optional<SMonitorInfoView> CWorkspaceManager::getMonitorView(std::string_view id) {
+    if (!m_pBackend)
         return std::nullopt;
 
-    // Try to get monitor by name first, then by ID
-    CMonitor* monitor = getMonitorByName(id);
-    if (!monitor) {
-        try {
-            MONITORID monID = std::stoll(id);
-            monitor = getMonitorByID(monID);
-        } catch (...) {
-            return std::nullopt;
-        }
-    }
+    VDM_VERIFY_INDEX();
 
-    if (!monitor)
+    const MONITORID monitorID = resolveMonitorID(id);
+    if (monitorID == -1)
         return std::nullopt;
 
-    MonitorInfo info;
-    info.id = monitor->m_id;
-    info.name = monitor->m_name;
-    info.description = monitor->m_description;
-    info.width = monitor->m_size.x;
-    info.height = monitor->m_size.y;
-    info.refreshRate = monitor->m_refreshRate;
-    info.x = monitor->m_position.x;
-    info.y = monitor->m_position.y;
-    
-    auto activeWorkspace = monitor->m_activeWorkspace;
-    if (activeWorkspace) {
-        info.activeWorkspaceID = activeWorkspace->m_id;
-        info.activeWorkspaceName = activeWorkspace->m_name;
-    } else {
-        info.activeWorkspaceID = -1;
-        info.activeWorkspaceName = "";
-    }
-
-    // Get all workspaces on this monitor
-    for (auto& workspace : g_pCompositor->getWorkspaces()) {
-        if (workspace && workspace->monitorID() == monitor->m_id) {
-            info.workspaces.push_back(workspace->m_id);
-        }
-    }
+    auto monitor = m_pBackend->getMonitorView(monitorID);
+    if (!monitor)
+        return std::nullopt;
 
-    return info;
+    return makeMonitorView(*monitor);
 }
 
-CMonitor* CWorkspaceManager::getActiveMonitor() {
-    if (!g_pCompositor)
-        return nullptr;
+std::vector<MonitorInfo> CWorkspaceManager::getAllMonitors() {
+    std::vector<MonitorInfo> monitors;
+    monitors.reserve(m_monitorIndex.size());
+    forEachMonitor([&](const SMonitorInfoView& view) { monitors.push_back(toInfo(view)); });
+    return monitors;
+}
 
-    if (auto monitor = g_pCompositor->getMonitorFromCursor(); monitor)
-        return monitor.get();
+std::optional<MonitorInfo> CWorkspaceManager::getMonitorInfo(const std::string& id) {
+    if (auto view = getMonitorView(id))
+        return toInfo(*view);
+    return std::nullopt;
+}
 
-    for (const auto& mon : g_pCompositor->m_realMonitors) {
-        if (mon)
-            return mon.get();
-    }
+MONITORID CWorkspaceManager::getActiveMonitorID() {
+    if (!m_pBackend)
+        return -1;
 
-    return nullptr;
+    return m_pBackend->getFocusedMonitorID();
 }
 
 size_t CWorkspaceManager::getMonitorCount() {
-    if (!g_pCompositor)
-        return 0;
-
-    return g_pCompositor->m_realMonitors.size();
+    return m_monitorIndex.size();
 }
 
 // Layout operations
 
 std::string CWorkspaceManager::getCurrentLayout() {
-    if (!g_pLayoutManager)
+    if (!m_pBackend)
         return "unknown";
 
-    auto layout = g_pLayoutManager->getCurrentLayout();
-    return layout ? layout->getLayoutName() : "unknown";
+    return m_pBackend->getCurrentLayout();
 }
 
 std::vector<std::string> CWorkspaceManager::getAvailableLayouts() {
     std::vector<std::string> layouts;
-    
-    if (!g_pLayoutManager)
+
+    if (!m_pBackend)
         return layouts;
 
-    // Since m_layouts is private, we can only get the current layout
-    // or return common Hyprland layouts
-    auto currentLayout = g_pLayoutManager->getCurrentLayout();
-    if (currentLayout) {
-        layouts.push_back(currentLayout->getLayoutName());
+    // The layout registry is private to Hyprland, so we can only get the
+    // current layout or return common Hyprland layouts
+    if (auto currentLayout = m_pBackend->getCurrentLayout(); currentLayout != "unknown") {
+        layouts.push_back(currentLayout);
     }
-    
+
     // Common Hyprland layouts
     if (std::find(layouts.begin(), layouts.end(), "dwindle") == layouts.end())
         layouts.push_back("dwindle");
@@ -496,19 +758,17 @@ std::vector<std::string> CWorkspaceManager::getAvailableLayouts() {
 
 LayoutInfo CWorkspaceManager::getLayoutInfo() {
     LayoutInfo info;
-    
-    if (!g_pLayoutManager) {
+
+    if (!m_pBackend) {
         info.name = "unknown";
         info.description = "Layout manager not available";
         return info;
     }
 
-    auto layout = g_pLayoutManager->getCurrentLayout();
-    if (layout) {
-        info.name = layout->getLayoutName();
+    info.name = m_pBackend->getCurrentLayout();
+    if (info.name != "unknown") {
         info.description = std::format("Current layout: {}", info.name);
     } else {
-        info.name = "unknown";
         info.description = "No layout active";
     }
 
@@ -518,35 +778,34 @@ LayoutInfo CWorkspaceManager::getLayoutInfo() {
 // Utility functions
 
 bool CWorkspaceManager::workspaceExists(WORKSPACEID id) {
-    return getWorkspaceByID(id) != nullptr;
+    return m_workspaceIndex.contains(id);
 }
 
 WORKSPACEID CWorkspaceManager::getNextAvailableWorkspaceID() {
-    if (!g_pCompositor)
-        return 1;
+    if (!m_pBackend)
+        return m_lastReservedID + 1;
 
-    WORKSPACEID maxID = 0;
-    for (auto& workspace : g_pCompositor->getWorkspaces()) {
-        if (workspace && workspace->m_id > maxID) {
-            maxID = workspace->m_id;
-        }
-    }
+    return m_idAllocator.findFree(m_lastReservedID + 1);
+}
+
+WORKSPACEID CWorkspaceManager::getNextAvailableWorkspaceID(WORKSPACEID first, WORKSPACEID last) {
+    if (!m_pBackend)
+        return first;
 
-    return maxID + 1;
+    const WORKSPACEID id = m_idAllocator.findFree(first, last);
+    return id != -1 ? id : m_idAllocator.findFree();
 }
 
 size_t CWorkspaceManager::getTotalWindowCount() {
-    if (!g_pCompositor)
+    if (!m_pBackend)
         return 0;
 
-    size_t count = 0;
-    for (auto& workspace : g_pCompositor->getWorkspaces()) {
-        if (workspace) {
-            count += workspace->getWindows();
-        }
-    }
+    return m_windowIndex.size();
+}
 
-    return count;
+SWindowCounters CWorkspaceManager::getWindowCounters(WORKSPACEID id) const {
+    auto it = m_workspaceIndex.find(id);
+    return it != m_workspaceIndex.end() ? it->second.windows : SWindowCounters{};
 }
 
 } // namespace VDM
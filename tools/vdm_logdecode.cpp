@@ -0,0 +1,254 @@
+// vdm-logdecode: render a binary log written by AppLog::openBinaryLog as text
+//
+// Usage: vdm-logdecode FILE...
+//
+// Every record becomes one line, "HH:MM:SS.uuuuuu LEVEL [category] [tag] msg",
+// with the message formatted from the call site's format string and the raw
+// arguments stored in the record. See include/BinaryLog.hpp for the layout.
+
+#include "BinaryLog.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace {
+
+    using namespace AppLog::binary;
+
+    using Arg = std::variant<int64_t, uint64_t, double, bool, char, std::string>;
+
+    struct SDecodedSite {
+        uint8_t level = 0;
+        std::string category;
+        std::string format;
+        std::vector<ArgType> types;
+    };
+
+    constexpr std::string_view LEVEL_NAMES[] = {"TRACE", "INFO", "WARN", "ERROR"};
+
+    /**
+     * Bounds-checked reader over the file contents
+     */
+    class CReader {
+    public:
+        explicit CReader(std::string_view data) : m_data(data) {}
+
+        bool atEnd() const { return m_pos >= m_data.size(); }
+        size_t position() const { return m_pos; }
+        void seek(size_t pos) { m_pos = std::min(pos, m_data.size()); }
+
+        template <typename T>
+        bool read(T& value) {
+            if (m_data.size() - m_pos < sizeof(T))
+                return false;
+            std::memcpy(&value, m_data.data() + m_pos, sizeof(T));
+            m_pos += sizeof(T);
+            return true;
+        }
+
+        bool readString(std::string& value) {
+            uint16_t length = 0;
+            if (!read(length) || m_data.size() - m_pos < length)
+                return false;
+            value.assign(m_data.data() + m_pos, length);
+            m_pos += length;
+            return true;
+        }
+
+    private:
+        std::string_view m_data;
+        size_t m_pos = 0;
+    };
+
+    bool readArg(CReader& reader, ArgType type, Arg& arg) {
+        switch (type) {
+            case ArgType::Int:    { int64_t v;  if (!reader.read(v)) return false; arg = v; return true; }
+            case ArgType::UInt:   { uint64_t v; if (!reader.read(v)) return false; arg = v; return true; }
+            case ArgType::Float:  { double v;   if (!reader.read(v)) return false; arg = v; return true; }
+            case ArgType::Bool:   { uint8_t v;  if (!reader.read(v)) return false; arg = v != 0; return true; }
+            case ArgType::Char:   { char v;     if (!reader.read(v)) return false; arg = v; return true; }
+            case ArgType::String: { std::string v; if (!reader.readString(v)) return false; arg = std::move(v); return true; }
+        }
+        return false;
+    }
+
+    void formatArg(std::string& out, const Arg& arg, std::string_view spec) {
+        const std::string fmt = std::format("{{:{}}}", spec);
+        std::visit([&](const auto& value) {
+            try {
+                std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(value));
+            } catch (const std::format_error&) {
+                // Spec written for the original type, e.g. "{:.2f}" on a value
+                // that was stored as a string: print the value as is
+                std::format_to(std::back_inserter(out), "{}", value);
+            }
+        }, arg);
+    }
+
+    /**
+     * Substitute the arguments into a std::format string, one field at a time
+     */
+    std::string render(std::string_view format, const std::vector<Arg>& args) {
+        std::string out;
+        size_t nextArg = 0;
+
+        for (size_t i = 0; i < format.size(); ++i) {
+            const char c = format[i];
+            if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c) {
+                out.push_back(c);
+                ++i;
+                continue;
+            }
+            if (c != '{') {
+                out.push_back(c);
+                continue;
+            }
+
+            const size_t close = format.find('}', i);
+            if (close == std::string_view::npos) {
+                out.append(format.substr(i));
+                break;
+            }
+
+            const std::string_view field = format.substr(i + 1, close - i - 1);
+            const size_t colon = field.find(':');
+            const std::string_view index = field.substr(0, colon);
+            const std::string_view spec = colon == std::string_view::npos ? std::string_view{} : field.substr(colon + 1);
+
+            size_t argIndex = nextArg++;
+            if (!index.empty())
+                argIndex = std::strtoul(std::string(index).c_str(), nullptr, 10);
+
+            if (argIndex < args.size())
+                formatArg(out, args[argIndex], spec);
+            else
+                out.append("{?}");
+
+            i = close;
+        }
+
+        return out;
+    }
+
+    std::string formatTime(uint64_t realtimeNs) {
+        const time_t seconds = static_cast<time_t>(realtimeNs / 1000000000ull);
+        tm local{};
+        localtime_r(&seconds, &local);
+
+        char buf[16];
+        std::strftime(buf, sizeof(buf), "%H:%M:%S", &local);
+        return std::format("{}.{:06}", buf, (realtimeNs % 1000000000ull) / 1000);
+    }
+
+    bool decode(const char* path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "vdm-logdecode: cannot open %s\n", path);
+            return false;
+        }
+        const std::string data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        CReader reader(data);
+
+        char magic[sizeof(MAGIC)];
+        uint64_t realtime = 0, steady = 0;
+        std::string tag;
+        if (!reader.read(magic) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !reader.read(realtime) ||
+            !reader.read(steady) || !reader.readString(tag)) {
+            std::fprintf(stderr, "vdm-logdecode: %s is not a VDM binary log\n", path);
+            return false;
+        }
+
+        std::unordered_map<uint32_t, SDecodedSite> sites;
+        std::vector<Arg> args;
+        std::string line;
+
+        while (!reader.atEnd()) {
+            uint8_t type = RECORD_END;
+            reader.read(type);
+
+            if (type == RECORD_END) {
+                // Rest of the chunk is padding
+                reader.seek((reader.position() + CHUNK_SIZE - 1) / CHUNK_SIZE * CHUNK_SIZE);
+                continue;
+            }
+
+            if (type == RECORD_SITE) {
+                uint32_t id = 0;
+                uint8_t argCount = 0;
+                SDecodedSite site;
+                if (!reader.read(id) || !reader.read(site.level) || !reader.readString(site.category) ||
+                    !reader.readString(site.format) || !reader.read(argCount))
+                    break;
+                site.types.resize(argCount);
+                for (auto& argType : site.types) {
+                    if (!reader.read(argType))
+                        break;
+                }
+                sites[id] = std::move(site);
+                continue;
+            }
+
+            if (type != RECORD_LOG) {
+                std::fprintf(stderr, "vdm-logdecode: %s: unknown record type %u at offset %zu\n", path, type,
+                             reader.position() - 1);
+                return false;
+            }
+
+            uint32_t id = 0;
+            uint64_t timestamp = 0;
+            if (!reader.read(id) || !reader.read(timestamp))
+                break;
+
+            auto it = sites.find(id);
+            if (it == sites.end()) {
+                std::fprintf(stderr, "vdm-logdecode: %s: record for undefined site %u\n", path, id);
+                return false;
+            }
+            const auto& site = it->second;
+
+            args.resize(site.types.size());
+            bool complete = true;
+            for (size_t i = 0; i < site.types.size() && complete; ++i)
+                complete = readArg(reader, site.types[i], args[i]);
+            if (!complete)
+                break;
+
+            line = formatTime(realtime + (timestamp - steady));
+            line.push_back(' ');
+            line.append(site.level < std::size(LEVEL_NAMES) ? LEVEL_NAMES[site.level] : "?");
+            line.push_back(' ');
+            if (!site.category.empty())
+                std::format_to(std::back_inserter(line), "[{}] ", site.category);
+            if (!tag.empty())
+                std::format_to(std::back_inserter(line), "[{}] ", tag);
+            line.append(render(site.format, args));
+            line.push_back('\n');
+            std::fwrite(line.data(), 1, line.size(), stdout);
+        }
+
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s FILE...\n", argv[0]);
+        return 1;
+    }
+
+    bool ok = true;
+    for (int i = 1; i < argc; ++i)
+        ok = decode(argv[i]) && ok;
+
+    return ok ? 0 : 1;
+}